@@ -6,7 +6,10 @@ in vec4 Color;
 out vec4 outColor;
 
 uniform sampler2D sampler;
-uniform float time;
+layout (std140, binding = 0) uniform Frame
+{
+	float time;
+};
 
 void main()
 {
@@ -0,0 +1,10 @@
+#version 430 core
+
+in vec4 Color;
+
+out vec4 outColor;
+
+void main()
+{
+	outColor = Color;
+}
@@ -0,0 +1,16 @@
+#version 430 core
+
+layout (location = 0) in vec2 inCorner;
+
+// per instance
+layout (location = 1) in vec2 inPosition;
+layout (location = 2) in vec2 inSize;
+layout (location = 3) in vec4 inColor;
+
+out vec4 Color;
+
+void main()
+{
+	Color = inColor;
+	gl_Position = vec4(inPosition + inCorner * inSize, 0.0, 1.0);
+}
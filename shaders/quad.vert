@@ -0,0 +1,16 @@
+#version 430 core
+
+layout (location = 0) in vec2 inCorner;
+
+// set before every draw, the per-draw counterpart of shaders/instanced.vert
+uniform vec2 position;
+uniform vec2 size;
+uniform vec4 color;
+
+out vec4 Color;
+
+void main()
+{
+	Color = color;
+	gl_Position = vec4(position + inCorner * size, 0.0, 1.0);
+}
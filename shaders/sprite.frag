@@ -0,0 +1,39 @@
+#version 430 core
+
+in vec2 TexCoords;
+in vec4 Color;
+flat in int TextureSlot;
+
+out vec4 outColor;
+
+uniform sampler2D samplers[16];
+
+// sampler arrays may only be indexed with dynamically uniform expressions, which the slot of a fragment
+// isn't, so every slot gets its own constant index
+vec4 sampleTexture(int slot, vec2 texCoords)
+{
+	switch (slot)
+	{
+		case 0: return texture(samplers[0], texCoords);
+		case 1: return texture(samplers[1], texCoords);
+		case 2: return texture(samplers[2], texCoords);
+		case 3: return texture(samplers[3], texCoords);
+		case 4: return texture(samplers[4], texCoords);
+		case 5: return texture(samplers[5], texCoords);
+		case 6: return texture(samplers[6], texCoords);
+		case 7: return texture(samplers[7], texCoords);
+		case 8: return texture(samplers[8], texCoords);
+		case 9: return texture(samplers[9], texCoords);
+		case 10: return texture(samplers[10], texCoords);
+		case 11: return texture(samplers[11], texCoords);
+		case 12: return texture(samplers[12], texCoords);
+		case 13: return texture(samplers[13], texCoords);
+		case 14: return texture(samplers[14], texCoords);
+		default: return texture(samplers[15], texCoords);
+	}
+}
+
+void main()
+{
+	outColor = sampleTexture(TextureSlot, TexCoords) * Color;
+}
@@ -0,0 +1,20 @@
+#version 430 core
+
+layout (location = 0) in vec2 inPosition;
+layout (location = 1) in vec2 inTexCoords;
+layout (location = 2) in vec4 inColor;
+layout (location = 3) in float inTextureSlot;
+
+out vec2 TexCoords;
+out vec4 Color;
+flat out int TextureSlot;
+
+uniform mat4 projection;
+
+void main()
+{
+	TexCoords = inTexCoords;
+	Color = inColor;
+	TextureSlot = int(inTextureSlot + 0.5);
+	gl_Position = projection * vec4(inPosition, 0.0, 1.0);
+}
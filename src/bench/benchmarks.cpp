@@ -0,0 +1,230 @@
+#include "benchmarks.hpp"
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "core/log.hpp"
+#include "gl/embedded_shaders.hpp"
+#include "gl/index_buffer.hpp"
+#include "gl/instanced_mesh.hpp"
+#include "gl/shader.hpp"
+#include "gl/sprite_batch.hpp"
+#include "gl/texture.hpp"
+#include "gl/vertex_array_cache.hpp"
+#include "gl/vertex_buffer.hpp"
+#include "gl/vertex_quantization.hpp"
+
+static constexpr u32 warmup_frames = 5;
+static constexpr u32 measured_frames = 50;
+
+static constexpr u32 sprite_grid_columns = 200;
+static constexpr u32 sprite_grid_rows = 100;
+
+static constexpr u32 quad_grid_columns = 400;
+static constexpr u32 quad_grid_rows = 250;
+
+struct QuadVertex
+{
+    glm::vec2 corner;
+};
+
+// one quad of the grid, set as uniforms when drawing per draw call
+struct QuadParameters
+{
+    glm::vec2 position;
+    glm::vec2 size;
+    glm::vec4 color;
+};
+
+// QuadParameters as uploaded for instancing, see shaders/instanced.vert
+struct QuadInstance
+{
+    glm::vec2 position;
+    HalfVec2 size;
+    Normalized<glm::u8vec4> color;
+};
+
+struct FrameTimes
+{
+    f64 cpu_ms;
+    f64 gpu_ms;
+    f64 finish_ms;
+};
+
+// Averages over measured_frames calls of draw. Every frame waits for its query result, so frames don't
+// overlap and the GPU time of one isn't hidden behind the submission of the next.
+template<typename Func> static auto measure_frames(Func&& draw) -> FrameTimes
+{
+    using milliseconds = std::chrono::duration<f64, std::milli>;
+
+    for (u32 frame = 0; frame < warmup_frames; frame++)
+        draw();
+
+    glFinish();
+
+    GLuint query;
+    glGenQueries(1, &query);
+
+    milliseconds cpu_time{};
+    GLuint64 gpu_time_ns = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (u32 frame = 0; frame < measured_frames; frame++)
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        glBeginQuery(GL_TIME_ELAPSED, query);
+
+        auto submit_start = std::chrono::steady_clock::now();
+        draw();
+        cpu_time += std::chrono::steady_clock::now() - submit_start;
+
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint64 elapsed_ns;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+        gpu_time_ns += elapsed_ns;
+    }
+
+    glFinish();
+    milliseconds finish_time = std::chrono::steady_clock::now() - start;
+    glDeleteQueries(1, &query);
+
+    auto frames = static_cast<f64>(measured_frames);
+
+    return {
+        .cpu_ms = cpu_time.count() / frames,
+        .gpu_ms = static_cast<f64>(gpu_time_ns) / 1'000'000.0 / frames,
+        .finish_ms = finish_time.count() / frames,
+    };
+}
+
+// covering the whole viewport, in normalized device coordinates
+[[nodiscard]] static auto make_quad_grid() -> std::vector<QuadParameters>
+{
+    auto size = glm::vec2{ 2.0f / quad_grid_columns, 2.0f / quad_grid_rows };
+
+    std::vector<QuadParameters> quads;
+    quads.reserve(quad_grid_columns * quad_grid_rows);
+
+    for (u32 row = 0; row < quad_grid_rows; row++)
+    {
+        for (u32 column = 0; column < quad_grid_columns; column++)
+        {
+            auto cell = glm::vec2{ static_cast<f32>(column), static_cast<f32>(row) };
+            auto position = glm::vec2{ -1.0f, -1.0f } + cell * size;
+            auto color = glm::vec4{ cell.x / quad_grid_columns, cell.y / quad_grid_rows, 1.0f, 1.0f };
+            quads.push_back({ .position = position, .size = size, .color = color });
+        }
+    }
+
+    return quads;
+}
+
+static auto log_frame_times(std::string_view name, const FrameTimes& times) -> void
+{
+    log_notification("{}: {:.3f} ms CPU, {:.3f} ms GPU, {:.3f} ms until finished per frame", name,
+                     times.cpu_ms, times.gpu_ms, times.finish_ms);
+}
+
+// The same quads drawn with a single instanced draw call, and with one draw call and three uniform updates
+// per quad.
+static auto benchmark_instancing() -> void
+{
+    // clang-format off
+    constexpr std::array<QuadVertex, 4> corners = {{
+        {{ 0.0f, 0.0f }},
+        {{ 1.0f, 0.0f }},
+        {{ 1.0f, 1.0f }},
+        {{ 0.0f, 1.0f }},
+    }};
+
+    constexpr std::array<GLushort, 6> indices = { 0, 1, 2, 0, 2, 3 };
+    // clang-format on
+
+    auto quads = make_quad_grid();
+    auto quad_count = quads.size();
+
+    InstancedMesh<QuadVertex, QuadInstance> mesh(corners, indices, quad_count);
+    mesh.set_instances(quantize_vertices<QuadInstance>(std::span<const QuadParameters>{ quads }));
+
+    Shader instanced_shader(embedded_shader(EmbeddedShaderId::instanced_vert),
+                            embedded_shader(EmbeddedShaderId::instanced_frag));
+
+    auto instanced = measure_frames([&] {
+        instanced_shader.use();
+        mesh.draw();
+    });
+
+    log_frame_times(std::format("instanced, {} quads in 1 draw call", quad_count), instanced);
+
+    VertexArrayCache vertex_arrays;
+    VertexBuffer vertex_buffer(std::span{ corners }, GL_STATIC_DRAW);
+    vertex_arrays.bind<QuadVertex>(vertex_buffer.id(), 0);
+    IndexBuffer index_buffer(std::span{ indices }, GL_STATIC_DRAW);
+
+    Shader per_draw_shader(embedded_shader(EmbeddedShaderId::quad_vert),
+                           embedded_shader(EmbeddedShaderId::instanced_frag));
+    auto position = per_draw_shader.get_uniform<glm::vec2>("position");
+    auto size = per_draw_shader.get_uniform<glm::vec2>("size");
+    auto color = per_draw_shader.get_uniform<glm::vec4>("color");
+
+    auto per_draw = measure_frames([&] {
+        per_draw_shader.use();
+        vertex_arrays.bind<QuadVertex>(vertex_buffer.id(), index_buffer.id());
+
+        for (const auto& quad : quads)
+        {
+            per_draw_shader.set_unif(position, quad.position);
+            per_draw_shader.set_unif(size, quad.size);
+            per_draw_shader.set_unif(color, quad.color);
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_SHORT, nullptr);
+        }
+    });
+
+    log_frame_times(std::format("per draw, {} quads in {} draw calls", quad_count, quad_count), per_draw);
+    log_notification("instanced: {:.1f}x faster until finished", per_draw.finish_ms / instanced.finish_ms);
+}
+
+// a grid of quads covering the viewport, all with the same texture
+static auto benchmark_sprite_batch() -> void
+{
+    Shader shader(embedded_shader(EmbeddedShaderId::sprite_vert),
+                  embedded_shader(EmbeddedShaderId::sprite_frag));
+    SpriteBatch batch(shader);
+
+    Texture2D texture(1, 1, 4);
+    std::array<u8, 4> white = { 255, 255, 255, 255 };
+    texture.bind();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, white.data());
+
+    auto sprite_size = glm::vec2{ 1.0f / sprite_grid_columns, 1.0f / sprite_grid_rows };
+
+    auto times = measure_frames([&] {
+        batch.begin(glm::ortho(0.0f, 1.0f, 0.0f, 1.0f));
+
+        for (u32 row = 0; row < sprite_grid_rows; row++)
+        {
+            for (u32 column = 0; column < sprite_grid_columns; column++)
+            {
+                auto position = glm::vec2{ static_cast<f32>(column), static_cast<f32>(row) } * sprite_size;
+                auto color = glm::vec4{ position.x, position.y, 1.0f, 1.0f };
+                batch.draw(texture, { .position = position, .size = sprite_size, .color = color });
+            }
+        }
+
+        batch.end();
+    });
+
+    auto quads = batch.stats().quads;
+    log_frame_times(std::format("sprite batch, {} quads in {} draw calls", quads, batch.stats().draw_calls),
+                    times);
+    log_notification("sprite batch: {:.0f} quads/s until finished",
+                     static_cast<f64>(quads) / (times.finish_ms / 1000.0));
+}
+
+auto run_benchmarks() -> void
+{
+    log_notification("{} frames per benchmark", measured_frames);
+    benchmark_sprite_batch();
+    benchmark_instancing();
+}
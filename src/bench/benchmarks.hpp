@@ -0,0 +1,6 @@
+#pragma once
+
+// Benchmarks of the batching paths, run with "example --benchmark"; a GL context has to be current and vsync
+// should be off. Every workload is drawn for a fixed number of frames and reported per frame as CPU
+// submission time, GPU time from GL_TIME_ELAPSED queries, and the time until glFinish returned.
+auto run_benchmarks() -> void;
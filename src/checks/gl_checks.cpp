@@ -0,0 +1,573 @@
+#include "gl_checks.hpp"
+
+#include <glad/glad.h>
+
+#include "core/log.hpp"
+#include "gl/compute_shader.hpp"
+#include "gl/mesh_heap.hpp"
+#include "gl/program_pipeline.hpp"
+#include "gl/shader_storage_buffer.hpp"
+#include "gl/texture_uploader.hpp"
+#include "io/image_decode_pool.hpp"
+#include "io/mapped_file.hpp"
+
+struct CheckContext
+{
+    u32 failed = 0;
+
+    auto expect(bool condition, std::string_view check, std::string_view what) -> void
+    {
+        if (condition) [[likely]]
+            return;
+
+        log_error("check failed: {}: {}", check, what);
+        failed++;
+    }
+};
+
+// A color texture to draw into and read back from; what's drawn into the default framebuffer of a hidden
+// window isn't guaranteed to stay there.
+class CheckFramebuffer
+{
+public:
+    static constexpr u32 size = 48;
+
+    explicit CheckFramebuffer() : _color(size, size, 4)
+    {
+        glGenFramebuffers(1, &_id);
+        glBindFramebuffer(GL_FRAMEBUFFER, _id);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _color.id(), 0);
+        gl_state().set_viewport({ .x = 0, .y = 0, .width = size, .height = size });
+    }
+
+    ~CheckFramebuffer() noexcept
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &_id);
+    }
+
+    CheckFramebuffer(const CheckFramebuffer& other) = delete;
+    CheckFramebuffer(CheckFramebuffer&& other) = delete;
+
+    [[nodiscard]] auto is_complete() const noexcept -> bool
+    {
+        return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    auto clear() const noexcept -> void
+    {
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    // the pixel at x and y in [0, 1) of the framebuffer's width and height
+    [[nodiscard]] auto read(f32 x, f32 y) const noexcept -> glm::u8vec4
+    {
+        glm::u8vec4 pixel;
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(static_cast<GLint>(x * size), static_cast<GLint>(y * size), 1, 1, GL_RGBA,
+                     GL_UNSIGNED_BYTE, &pixel);
+        return pixel;
+    }
+
+private:
+    GLuint _id;
+    Texture2D _color;
+};
+
+struct ColoredVertex
+{
+    glm::vec2 position;
+    glm::vec3 color;
+};
+
+static constexpr std::string_view colored_vertex_source = R"(#version 430 core
+
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec3 color;
+
+out vec3 vertex_color;
+
+void main()
+{
+    vertex_color = color;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)";
+
+static constexpr std::string_view colored_fragment_source = R"(#version 430 core
+
+in vec3 vertex_color;
+
+out vec4 fragment_color;
+
+void main()
+{
+    fragment_color = vec4(vertex_color, 1.0);
+}
+)";
+
+// a quad over the full height of the viewport, between left and right in normalized device coordinates
+[[nodiscard]] static auto make_colored_quad(f32 left, f32 right, const glm::vec3& color)
+    -> std::array<ColoredVertex, 4>
+{
+    return { {
+        { .position = { left, -1.0f }, .color = color },
+        { .position = { right, -1.0f }, .color = color },
+        { .position = { right, 1.0f }, .color = color },
+        { .position = { left, 1.0f }, .color = color },
+    } };
+}
+
+// Uploads an image in more bands than there are slots, so every slot is reused behind a fence, and reads
+// it back from the texture.
+static auto check_texture_uploader(CheckContext& context) -> void
+{
+    constexpr std::string_view check = "texture uploader";
+    constexpr u32 width = 64;
+    constexpr u32 height = 100;
+    constexpr u32 channels = 4;
+    constexpr u32 rows_per_slot = 16;
+
+    std::vector<u8> pixels(width * height * channels);
+
+    for (usize i = 0; i < pixels.size(); i++)
+        pixels[i] = static_cast<u8>(i * 7 + i / 251);
+
+    Texture2D texture(width, height, channels);
+    TextureUploader uploader(width * channels * rows_per_slot, 2);
+    uploader.upload(texture, { .width = width, .height = height }, pixels);
+
+    std::vector<u8> read_back(pixels.size());
+    texture.bind();
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, read_back.data());
+
+    context.expect(read_back == pixels, check, "texture contents differ from the uploaded pixels");
+
+    auto expect_rejected = [&](auto&& upload, std::string_view what) {
+        try
+        {
+            upload();
+            context.expect(false, check, what);
+        }
+        catch (TextureUploadError&)
+        {
+        }
+    };
+
+    // regions that don't fit in a slot or aren't covered by the pixels are rejected up front, not read or
+    // written past the end
+    auto full_region = TextureUploadRegion{ .width = width, .height = height };
+    auto oversized_region = TextureUploadRegion{ .width = width, .height = rows_per_slot + 1 };
+    auto short_pixels = std::span<const u8>{ pixels }.first(pixels.size() - 1);
+
+    expect_rejected([&] { (void)uploader.begin_upload(texture, oversized_region); },
+                    "a region bigger than a slot was accepted");
+    expect_rejected([&] { uploader.upload(texture, full_region, short_pixels); },
+                    "fewer pixels than the region covers were accepted");
+    expect_rejected([&] { uploader.end_upload(texture); },
+                    "end_upload() without begin_upload() was accepted");
+
+    context.expect(glGetError() == GL_NO_ERROR, check, "GL error");
+}
+
+// Decodes a batch of files through the batch reader, which uses io_uring where it can, and compares the
+// images to one decoded directly. Runs from the repository root, like the example.
+static auto check_image_decode_pool(CheckContext& context) -> void
+{
+    constexpr std::string_view check = "image decode pool";
+    const std::filesystem::path path = "res/emoji.png";
+
+    MappedFile file(path);
+    Image expected(file.bytes());
+
+    ImageDecodePool decoder(2);
+    std::vector<std::filesystem::path> paths(5, path);
+    auto images = decoder.decode_all(paths);
+
+    auto is_expected = [&](const Image& image) {
+        return image.width() == expected.width() && image.height() == expected.height()
+               && image.channels() == expected.channels()
+               && std::ranges::equal(image.pixels(), expected.pixels());
+    };
+
+    auto matches = images.size() == paths.size() && std::ranges::all_of(images, is_expected);
+    context.expect(matches, check, "batch decoded images differ from a direct decode");
+    log_notification("{}: {} files read {}", check, paths.size(),
+                     decoder.uses_io_uring() ? "through io_uring" : "on the fallback thread pool");
+
+    // one missing file fails the whole batch
+    paths.emplace_back("res/missing.png");
+    auto rejected = false;
+
+    try
+    {
+        (void)decoder.decode_all(paths);
+    }
+    catch (FileIoError&)
+    {
+        rejected = true;
+    }
+
+    context.expect(rejected, check, "a batch with a missing file was decoded");
+}
+
+// Fills a mesh heap with three quads side by side, removes the middle one and adds another in its place.
+// The blocks only have room for three quads, so the new one has to reuse the freed range.
+static auto check_mesh_heap(CheckContext& context) -> void
+{
+    constexpr std::string_view check = "mesh heap";
+    constexpr std::array<GLushort, 6> indices = { 0, 1, 2, 0, 2, 3 };
+    constexpr usize vertex_block_size = 3 * 4 * sizeof(ColoredVertex);
+    constexpr usize index_block_size = 3 * sizeof(indices);
+
+    constexpr glm::u8vec4 red = { 255, 0, 0, 255 };
+    constexpr glm::u8vec4 green = { 0, 255, 0, 255 };
+    constexpr glm::u8vec4 blue = { 0, 0, 255, 255 };
+    constexpr glm::u8vec4 white = { 255, 255, 255, 255 };
+
+    CheckFramebuffer framebuffer;
+    context.expect(framebuffer.is_complete(), check, "framebuffer isn't complete");
+
+    Shader shader(ShaderSources{ .vertex = colored_vertex_source, .fragment = colored_fragment_source });
+    MeshHeap<ColoredVertex> heap(vertex_block_size, index_block_size);
+
+    auto left_quad = make_colored_quad(-1.0f, -1.0f / 3.0f, { 1.0f, 0.0f, 0.0f });
+    auto middle_quad = make_colored_quad(-1.0f / 3.0f, 1.0f / 3.0f, { 0.0f, 1.0f, 0.0f });
+    auto right_quad = make_colored_quad(1.0f / 3.0f, 1.0f, { 0.0f, 0.0f, 1.0f });
+    auto replacement_quad = make_colored_quad(-1.0f / 3.0f, 1.0f / 3.0f, { 1.0f, 1.0f, 1.0f });
+
+    std::array meshes = {
+        heap.add(left_quad, indices),
+        heap.add(middle_quad, indices),
+        heap.add(right_quad, indices),
+    };
+
+    auto draw_meshes = [&] {
+        framebuffer.clear();
+        shader.use();
+
+        for (const auto& mesh : meshes)
+            heap.draw(mesh);
+    };
+
+    auto expect_colors = [&](const glm::u8vec4& middle, std::string_view what) {
+        auto matches = framebuffer.read(1.0f / 6.0f, 0.5f) == red && framebuffer.read(0.5f, 0.5f) == middle
+                       && framebuffer.read(5.0f / 6.0f, 0.5f) == blue;
+        context.expect(matches, check, what);
+    };
+
+    auto expect_free_space = [&](usize vertex_bytes, usize index_bytes, std::string_view what) {
+        auto matches = heap.vertex_heap().block_count() == 1 && heap.index_heap().block_count() == 1
+                       && heap.vertex_heap().block_free_space(0) == vertex_bytes
+                       && heap.index_heap().block_free_space(0) == index_bytes;
+        context.expect(matches, check, what);
+    };
+
+    expect_free_space(0, 0, "three quads don't fill exactly one block of each heap");
+    context.expect(meshes[2].base_vertex == 8, check, "wrong base vertex of the third quad");
+
+    draw_meshes();
+    expect_colors(green, "wrong colors drawn");
+
+    auto removed = meshes[1];
+    heap.remove(removed);
+    expect_free_space(sizeof(middle_quad), sizeof(indices), "removing a quad didn't free its ranges");
+
+    meshes[1] = heap.add(replacement_quad, indices);
+    auto reused = meshes[1].vertices.offset == removed.vertices.offset
+                  && meshes[1].indices.offset == removed.indices.offset
+                  && meshes[1].base_vertex == removed.base_vertex;
+    context.expect(reused, check, "a quad added after removing one didn't reuse the freed ranges");
+    expect_free_space(0, 0, "a quad added after removing one took a new block");
+
+    draw_meshes();
+    expect_colors(white, "wrong colors drawn after replacing a quad");
+
+    // the freed ranges are merged again, a mesh as big as all three fits in the same block
+    for (const auto& mesh : meshes)
+        heap.remove(mesh);
+
+    expect_free_space(vertex_block_size, index_block_size, "removing every quad didn't free the blocks");
+
+    std::vector<ColoredVertex> all_vertices;
+    std::vector<GLushort> all_indices;
+
+    for (const auto& quad : { left_quad, replacement_quad, right_quad })
+    {
+        for (auto index : indices)
+            all_indices.push_back(static_cast<GLushort>(all_vertices.size() + index));
+
+        all_vertices.insert(all_vertices.end(), quad.begin(), quad.end());
+    }
+
+    auto merged = heap.add(all_vertices, all_indices);
+    expect_free_space(0, 0, "freed ranges weren't merged");
+
+    framebuffer.clear();
+    shader.use();
+    heap.draw(merged);
+    expect_colors(white, "wrong colors drawn from a single mesh");
+
+    context.expect(glGetError() == GL_NO_ERROR, check, "GL error");
+}
+
+// covers the viewport from left to right in normalized device coordinates, drawn as a 4 vertex triangle strip
+static constexpr std::string_view quad_stage_vertex_source = R"(#version 430 core
+
+out gl_PerVertex
+{{
+    vec4 gl_Position;
+}};
+
+const float left = {:.1f};
+const float right = {:.1f};
+
+void main()
+{{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    gl_Position = vec4(mix(left, right, corner.x), corner.y * 2.0 - 1.0, 0.0, 1.0);
+}}
+)";
+
+static constexpr std::string_view color_stage_fragment_source = R"(#version 430 core
+
+layout (location = 0) out vec4 fragment_color;
+
+void main()
+{{
+    fragment_color = vec4({:.1f}, {:.1f}, {:.1f}, 1.0);
+}}
+)";
+
+// Combines two vertex stages, covering the left or the right half of the viewport, with two fragment stages
+// of different colors, and draws with each of the four pipelines.
+static auto check_program_pipelines(CheckContext& context) -> void
+{
+    constexpr std::string_view check = "program pipelines";
+    constexpr glm::u8vec4 black = { 0, 0, 0, 255 };
+    constexpr std::array<f32, 2> half_centers = { 0.25f, 0.75f };
+    constexpr std::array<glm::u8vec4, 2> colors = { { { 255, 0, 0, 255 }, { 0, 255, 0, 255 } } };
+    constexpr std::string_view compute_source = "#version 430 core\n"
+                                                "layout (local_size_x = 1) in;\n"
+                                                "void main() {}\n";
+
+    CheckFramebuffer framebuffer;
+    VertexArray vertex_array;
+
+    std::array vertex_sources = { std::format(quad_stage_vertex_source, -1.0f, 0.0f),
+                                  std::format(quad_stage_vertex_source, 0.0f, 1.0f) };
+    std::array fragment_sources = { std::format(color_stage_fragment_source, 1.0f, 0.0f, 0.0f),
+                                    std::format(color_stage_fragment_source, 0.0f, 1.0f, 0.0f) };
+
+    std::array<std::unique_ptr<ShaderStage>, 2> vertex_stages;
+    std::array<std::unique_ptr<ShaderStage>, 2> fragment_stages;
+
+    for (usize i = 0; i < 2; i++)
+    {
+        vertex_stages[i] = std::make_unique<ShaderStage>(GL_VERTEX_SHADER, vertex_sources[i], "quad_stage");
+        fragment_stages[i] =
+            std::make_unique<ShaderStage>(GL_FRAGMENT_SHADER, fragment_sources[i], "color_stage");
+    }
+
+    ProgramPipelineCache pipelines;
+
+    for (usize vertex = 0; vertex < 2; vertex++)
+    {
+        for (usize fragment = 0; fragment < 2; fragment++)
+        {
+            framebuffer.clear();
+            vertex_array.bind();
+            pipelines.get(*vertex_stages[vertex], *fragment_stages[fragment]).bind();
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+            auto covered = framebuffer.read(half_centers[vertex], 0.5f);
+            auto uncovered = framebuffer.read(half_centers[1 - vertex], 0.5f);
+            auto what = std::format("wrong colors drawn with vertex stage {} and fragment stage {}", vertex,
+                                    fragment);
+            context.expect(covered == colors[fragment] && uncovered == black, check, what);
+        }
+    }
+
+    context.expect(pipelines.size() == 4, check, "the cache doesn't hold one pipeline per combination");
+
+    const auto& pipeline = pipelines.get(*vertex_stages[0], *fragment_stages[1]);
+    const auto& same_pipeline = pipelines.get(*vertex_stages[0], *fragment_stages[1]);
+    context.expect(&pipeline == &same_pipeline && pipelines.size() == 4, check,
+                   "a pipeline was created twice");
+
+    auto expect_rejected = [&](auto&& create, std::string_view what) {
+        try
+        {
+            create();
+            context.expect(false, check, what);
+        }
+        catch (CreateShaderError&)
+        {
+        }
+    };
+
+    expect_rejected([&] { (void)pipelines.get(*fragment_stages[0], *vertex_stages[0]); },
+                    "swapped stages were accepted");
+    expect_rejected([&] { ShaderStage stage(GL_COMPUTE_SHADER, compute_source); },
+                    "a compute stage was accepted");
+    context.expect(pipelines.size() == 4, check, "a rejected pipeline was cached");
+
+    pipelines.remove(*vertex_stages[0]);
+    context.expect(pipelines.size() == 2, check, "removing a stage didn't drop its pipelines");
+
+    context.expect(glGetError() == GL_NO_ERROR, check, "GL error");
+}
+
+// one element of the Grid block of fill_grid_source, padded to 16 bytes in std430
+struct GridCell
+{
+    glm::uvec2 cell;
+    GLuint value;
+};
+
+// writes every cell of a width x height grid, with partial work groups at the edges
+static constexpr std::string_view fill_grid_source = R"(#version 430 core
+
+layout (local_size_x = 64, local_size_y = 2) in;
+
+struct GridCell
+{
+    uvec2 cell;
+    uint value;
+};
+
+layout (std430, binding = 0) buffer Grid
+{
+    GridCell cells[];
+};
+
+uniform uint width;
+uniform uint height;
+uniform uint multiplier;
+
+void main()
+{
+    uvec2 cell = gl_GlobalInvocationID.xy;
+
+    if (cell.x >= width || cell.y >= height)
+        return;
+
+    uint index = cell.y * width + cell.x;
+    cells[index].cell = cell;
+    cells[index].value = index * multiplier;
+}
+)";
+
+// Dispatches into a storage buffer directly and indirectly and reads the results back, then overwrites a
+// few elements through the buffer's CPU copy.
+static auto check_compute_shader(CheckContext& context) -> void
+{
+    constexpr std::string_view check = "compute shader";
+    constexpr u32 width = 100;
+    constexpr u32 height = 3;
+    constexpr u32 cell_count = width * height;
+    constexpr u32 storage_binding = 0;
+
+    ComputeShader shader(fill_grid_source, "fill_grid");
+    shader.set_unif<GLuint>("width", width);
+    shader.set_unif<GLuint>("height", height);
+
+    auto group_count = shader.group_count_for({ width, height, 1 });
+    context.expect(shader.work_group_size() == glm::uvec3{ 64, 2, 1 }, check, "wrong work group size");
+    context.expect(group_count == glm::uvec3{ 2, 2, 1 }, check, "wrong group count");
+    context.expect(shader.is_storage_block_compatible<GridCell>("Grid"), check,
+                   "Grid isn't an array of GridCell in std430");
+
+    ShaderStorageBuffer<GridCell> grid(cell_count);
+    grid.bind(storage_binding);
+
+    // expected_cell(index) is the cell and value the element at index should have
+    auto expect_grid = [&](auto&& expected_cell, std::string_view what) {
+        constexpr auto words_per_cell = ShaderStorageBuffer<GridCell>::stride / sizeof(GLuint);
+
+        std::vector<GLuint> words(cell_count * words_per_cell);
+        gl_state().bind_buffer(GL_SHADER_STORAGE_BUFFER, grid.id());
+        auto size = static_cast<GLsizeiptr>(words.size() * sizeof(GLuint));
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, words.data());
+
+        auto matches = true;
+
+        for (u32 i = 0; i < cell_count; i++)
+        {
+            GridCell expected = expected_cell(i);
+            auto first_word = i * words_per_cell;
+            matches = matches && words[first_word] == expected.cell.x
+                      && words[first_word + 1] == expected.cell.y && words[first_word + 2] == expected.value;
+        }
+
+        context.expect(matches, check, what);
+    };
+
+    auto filled_cell = [&](u32 multiplier) {
+        return [=](u32 index) { return GridCell{ { index % width, index / width }, index * multiplier }; };
+    };
+
+    shader.set_unif<GLuint>("multiplier", 3);
+    shader.dispatch(group_count);
+    memory_barrier(BarrierBits::buffer_readback);
+    expect_grid(filled_cell(3), "wrong results from dispatch()");
+
+    auto command = DispatchIndirectCommand{ group_count.x, group_count.y, group_count.z };
+    GLuint command_buffer;
+    glGenBuffers(1, &command_buffer);
+    gl_state().bind_buffer(GL_DISPATCH_INDIRECT_BUFFER, command_buffer);
+    glBufferData(GL_DISPATCH_INDIRECT_BUFFER, sizeof(command), &command, GL_STATIC_DRAW);
+
+    shader.set_unif<GLuint>("multiplier", 5);
+    shader.dispatch_indirect(command_buffer);
+    memory_barrier(BarrierBits::buffer_readback);
+    expect_grid(filled_cell(5), "wrong results from dispatch_indirect()");
+
+    // only the elements set since the last flush are uploaded, the rest of the CPU copy is still zeroed and
+    // would overwrite the dispatch results
+    constexpr u32 first_set = 10;
+    constexpr u32 set_count = 20;
+    std::vector<GridCell> set_cells(set_count);
+
+    for (u32 i = 0; i < set_count; i++)
+        set_cells[i] = { { i, i }, 1000 + i };
+
+    grid.set(first_set, set_cells);
+    grid.set(first_set + set_count, GridCell{ { 7, 7 }, 7 });
+    context.expect(grid.is_dirty(), check, "setting elements didn't mark the buffer dirty");
+    grid.flush();
+    context.expect(!grid.is_dirty(), check, "flushing didn't clear the dirty range");
+
+    expect_grid(
+        [&](u32 index) {
+            if (index >= first_set && index < first_set + set_count)
+                return set_cells[index - first_set];
+
+            if (index == first_set + set_count)
+                return GridCell{ { 7, 7 }, 7 };
+
+            return filled_cell(5)(index);
+        },
+        "flush() didn't upload exactly the elements set");
+
+    gl_state().delete_buffer(command_buffer);
+    context.expect(glGetError() == GL_NO_ERROR, check, "GL error");
+}
+
+auto run_gl_checks() -> bool
+{
+    CheckContext context;
+    check_texture_uploader(context);
+    check_image_decode_pool(context);
+    check_mesh_heap(context);
+    check_program_pipelines(context);
+    check_compute_shader(context);
+
+    if (context.failed != 0)
+        return false;
+
+    log_notification("all GL checks passed");
+    return true;
+}
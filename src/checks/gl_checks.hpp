@@ -0,0 +1,7 @@
+#pragma once
+
+// Checks of GL code paths against the real driver, with a context but nothing on screen, so they also run
+// under a software rasterizer like llvmpipe. Run with "example --check"; a GL context has to be current.
+
+// logs every failed check, returns true if all of them passed
+[[nodiscard]] auto run_gl_checks() -> bool;
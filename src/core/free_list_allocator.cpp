@@ -0,0 +1,85 @@
+#include "free_list_allocator.hpp"
+
+FreeListAllocator::FreeListAllocator(usize capacity) : _capacity(capacity), _free_space(0)
+{
+    if (capacity != 0)
+        insert_free_block(0, capacity);
+}
+
+auto FreeListAllocator::allocate(usize size, usize alignment) -> std::optional<usize>
+{
+    if (size == 0)
+        size = 1;
+
+    // smallest blocks first; alignment padding can make a block that's big enough on paper unusable, in
+    // which case the next bigger one is tried
+    for (auto block = _blocks_by_size.lower_bound(size); block != _blocks_by_size.end(); ++block)
+    {
+        auto [block_size, block_offset] = *block;
+        auto aligned_offset = (block_offset + alignment - 1) / alignment * alignment;
+        auto padding = aligned_offset - block_offset;
+
+        if (padding + size > block_size)
+            continue;
+
+        erase_free_block(_blocks_by_offset.find(block_offset));
+
+        if (padding != 0)
+            insert_free_block(block_offset, padding);
+
+        if (auto tail_size = block_size - padding - size; tail_size != 0)
+            insert_free_block(aligned_offset + size, tail_size);
+
+        return aligned_offset;
+    }
+
+    return std::nullopt;
+}
+
+auto FreeListAllocator::free(usize offset, usize size) -> void
+{
+    if (size == 0)
+        size = 1;
+
+    auto next = _blocks_by_offset.lower_bound(offset);
+
+    if (next != _blocks_by_offset.end() && offset + size == next->first)
+    {
+        size += next->second;
+        erase_free_block(next);
+    }
+
+    auto prev = _blocks_by_offset.lower_bound(offset);
+
+    if (prev != _blocks_by_offset.begin())
+    {
+        --prev;
+
+        if (prev->first + prev->second == offset)
+        {
+            offset = prev->first;
+            size += prev->second;
+            erase_free_block(prev);
+        }
+    }
+
+    insert_free_block(offset, size);
+}
+
+auto FreeListAllocator::insert_free_block(usize offset, usize size) -> void
+{
+    _blocks_by_offset.emplace(offset, size);
+    _blocks_by_size.emplace(size, offset);
+    _free_space += size;
+}
+
+auto FreeListAllocator::erase_free_block(std::map<usize, usize>::iterator block) -> void
+{
+    auto [offset, size] = *block;
+    auto [first, last] = _blocks_by_size.equal_range(size);
+    auto by_size = std::ranges::find(first, last, offset, [](const auto& entry) { return entry.second; });
+
+    _blocks_by_size.erase(by_size);
+    _blocks_by_offset.erase(block);
+    _free_space -= size;
+}
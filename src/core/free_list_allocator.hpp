@@ -0,0 +1,28 @@
+#pragma once
+
+// Hands out ranges of an abstract [0, capacity) address space, e.g. offsets into a GPU buffer. Best fit
+// over free blocks indexed by size, with neighbouring free blocks coalesced on free, so both operations
+// are O(log n) in the number of free blocks.
+class FreeListAllocator
+{
+public:
+    explicit FreeListAllocator(usize capacity);
+
+    // alignment doesn't have to be a power of two (e.g. vertex sizes)
+    [[nodiscard]] auto allocate(usize size, usize alignment = 1) -> std::optional<usize>;
+    // size has to be the same as passed to allocate()
+    auto free(usize offset, usize size) -> void;
+
+    [[nodiscard]] inline auto capacity() const noexcept -> usize { return _capacity; }
+    [[nodiscard]] inline auto free_space() const noexcept -> usize { return _free_space; }
+
+private:
+    auto insert_free_block(usize offset, usize size) -> void;
+    auto erase_free_block(std::map<usize, usize>::iterator block) -> void;
+
+private:
+    usize _capacity;
+    usize _free_space;
+    std::map<usize, usize> _blocks_by_offset{};    // offset -> size
+    std::multimap<usize, usize> _blocks_by_size{}; // size -> offset
+};
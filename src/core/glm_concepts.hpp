@@ -0,0 +1,15 @@
+#pragma once
+
+// glm types told apart by their member types, which works for every length, value type and qualifier
+
+template<typename T>
+concept GlmMatrix = requires {
+    typename T::col_type;
+    typename T::row_type;
+};
+
+template<typename T>
+concept GlmVector = !GlmMatrix<T> && requires {
+    typename T::value_type;
+    T::length();
+};
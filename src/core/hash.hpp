@@ -0,0 +1,35 @@
+#pragma once
+
+// 64-bit FNV-1a. Unlike std::hash the result is stable across runs, compilers and platforms, so it's
+// safe to persist in files.
+
+static constexpr u64 fnv1a_64_offset_basis = 0xcbf29ce484222325;
+static constexpr u64 fnv1a_64_prime = 0x100000001b3;
+
+[[nodiscard]] constexpr inline auto fnv1a_64(std::string_view data, u64 seed = fnv1a_64_offset_basis) noexcept
+    -> u64
+{
+    u64 hash = seed;
+
+    for (char c : data)
+    {
+        hash ^= static_cast<u8>(c);
+        hash *= fnv1a_64_prime;
+    }
+
+    return hash;
+}
+
+[[nodiscard]] inline auto fnv1a_64(std::span<const std::byte> data, u64 seed = fnv1a_64_offset_basis) noexcept
+    -> u64
+{
+    u64 hash = seed;
+
+    for (std::byte b : data)
+    {
+        hash ^= static_cast<u8>(b);
+        hash *= fnv1a_64_prime;
+    }
+
+    return hash;
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+// Compile-time reflection of aggregates: the number of fields is found by trying to brace-initialize the
+// type from more and more values convertible to anything, the fields themselves through structured
+// bindings.
+
+template<usize n> struct Anything
+{
+    template<typename T> constexpr inline operator T() const { return T{}; };
+};
+
+template<typename T, usize... ints>
+concept ConstructibleFromNInitializers = requires { T{ Anything<ints>{}... }; };
+
+template<typename T, usize n> static constexpr inline auto is_constructible_from_n_initializers() -> bool
+{
+    constexpr auto unpack = [&]<usize... ints>(std::index_sequence<ints...>) {
+        return ConstructibleFromNInitializers<T, ints...>;
+    };
+
+    return unpack(std::make_index_sequence<n>{});
+}
+
+template<typename T, usize n = 0u> static constexpr inline auto get_struct_arity() -> usize
+{
+    constexpr auto constructible = is_constructible_from_n_initializers<T, n>();
+
+    if constexpr (!constructible)
+        return n - 1;
+    else if constexpr (constructible)
+        return get_struct_arity<T, n + 1>();
+    else
+        return get_struct_arity<T, n + 1>();
+}
+
+// the most fields tie_struct_fields handles, one structured binding branch each
+static constexpr usize max_reflected_struct_arity = 32;
+
+// references to all fields of an aggregate, in declaration order; at most max_reflected_struct_arity
+template<typename T> constexpr inline auto tie_struct_fields(T& value) noexcept
+{
+    constexpr auto arity = get_struct_arity<std::remove_cv_t<T>>();
+    static_assert(arity <= max_reflected_struct_arity,
+                  "vertex/std-layout structs are limited to max_reflected_struct_arity fields");
+
+    if constexpr (arity == 0)
+    {
+        return std::tie();
+    }
+    else if constexpr (arity == 1)
+    {
+        auto& [m1] = value;
+        return std::tie(m1);
+    }
+    else if constexpr (arity == 2)
+    {
+        auto& [m1, m2] = value;
+        return std::tie(m1, m2);
+    }
+    else if constexpr (arity == 3)
+    {
+        auto& [m1, m2, m3] = value;
+        return std::tie(m1, m2, m3);
+    }
+    else if constexpr (arity == 4)
+    {
+        auto& [m1, m2, m3, m4] = value;
+        return std::tie(m1, m2, m3, m4);
+    }
+    else if constexpr (arity == 5)
+    {
+        auto& [m1, m2, m3, m4, m5] = value;
+        return std::tie(m1, m2, m3, m4, m5);
+    }
+    else if constexpr (arity == 6)
+    {
+        auto& [m1, m2, m3, m4, m5, m6] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6);
+    }
+    else if constexpr (arity == 7)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7);
+    }
+    else if constexpr (arity == 8)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8);
+    }
+    else if constexpr (arity == 9)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9);
+    }
+    else if constexpr (arity == 10)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10);
+    }
+    else if constexpr (arity == 11)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11);
+    }
+    else if constexpr (arity == 12)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12);
+    }
+    else if constexpr (arity == 13)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13);
+    }
+    else if constexpr (arity == 14)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14);
+    }
+    else if constexpr (arity == 15)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15);
+    }
+    else if constexpr (arity == 16)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16);
+    }
+    else if constexpr (arity == 17)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17);
+    }
+    else if constexpr (arity == 18)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18);
+    }
+    else if constexpr (arity == 19)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19);
+    }
+    else if constexpr (arity == 20)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19,
+               m20] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20);
+    }
+    else if constexpr (arity == 21)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21);
+    }
+    else if constexpr (arity == 22)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22);
+    }
+    else if constexpr (arity == 23)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23);
+    }
+    else if constexpr (arity == 24)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24);
+    }
+    else if constexpr (arity == 25)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25);
+    }
+    else if constexpr (arity == 26)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25, m26] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25, m26);
+    }
+    else if constexpr (arity == 27)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25, m26, m27] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25, m26, m27);
+    }
+    else if constexpr (arity == 28)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25, m26, m27, m28] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25, m26, m27, m28);
+    }
+    else if constexpr (arity == 29)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25, m26, m27, m28, m29] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25, m26, m27, m28, m29);
+    }
+    else if constexpr (arity == 30)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25, m26, m27, m28, m29, m30] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25, m26, m27, m28, m29, m30);
+    }
+    else if constexpr (arity == 31)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25, m26, m27, m28, m29, m30, m31] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25, m26, m27, m28, m29, m30, m31);
+    }
+    else if constexpr (arity == 32)
+    {
+        auto& [m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20,
+               m21, m22, m23, m24, m25, m26, m27, m28, m29, m30, m31, m32] = value;
+        return std::tie(m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18,
+                        m19, m20, m21, m22, m23, m24, m25, m26, m27, m28, m29, m30, m31, m32);
+    }
+}
+
+template<typename Tuple> struct RemoveTupleReferences;
+
+template<typename... Ts> struct RemoveTupleReferences<std::tuple<Ts...>>
+{
+    using type = std::tuple<std::remove_cvref_t<Ts>...>;
+};
+
+// std::tuple of the field types of an aggregate
+template<typename T>
+using StructFieldTypes =
+    typename RemoveTupleReferences<decltype(tie_struct_fields(std::declval<T&>()))>::type;
+
+// calls func with a reference to each field, in declaration order
+template<typename T, typename Func> constexpr inline auto for_each_struct_field(T& value, Func&& func) -> void
+{
+    std::apply([&](auto&... fields) { (func(fields), ...); }, tie_struct_fields(value));
+}
@@ -0,0 +1,67 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(usize thread_count)
+{
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    _threads.reserve(thread_count);
+
+    for (usize i = 0; i < thread_count; i++)
+        _threads.emplace_back([this](std::stop_token stop_token) { worker_loop(stop_token); });
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    for (auto& thread : _threads)
+        thread.request_stop();
+
+    // jthreads join on destruction, which happens before the rest of the members are destroyed
+    _threads.clear();
+}
+
+auto ThreadPool::wait_idle() -> void
+{
+    std::unique_lock lock(_mutex);
+    _idle.wait(lock, [this] { return _tasks.empty() && _busy_count == 0; });
+}
+
+auto ThreadPool::enqueue(std::move_only_function<void()> task) -> void
+{
+    {
+        std::scoped_lock lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+
+    _task_available.notify_one();
+}
+
+auto ThreadPool::worker_loop(std::stop_token stop_token) -> void
+{
+    while (true)
+    {
+        std::move_only_function<void()> task;
+
+        {
+            std::unique_lock lock(_mutex);
+
+            if (!_task_available.wait(lock, stop_token, [this] { return !_tasks.empty(); }))
+                return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+            _busy_count++;
+        }
+
+        // packaged_task stores exceptions in the future, so nothing escapes here
+        task();
+
+        {
+            std::scoped_lock lock(_mutex);
+            _busy_count--;
+
+            if (_tasks.empty() && _busy_count == 0)
+                _idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+class ThreadPool
+{
+public:
+    // 0 means one thread per hardware thread
+    explicit ThreadPool(usize thread_count = 0);
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool(ThreadPool&& other) = delete;
+
+    template<typename Func> auto submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Func>>;
+
+        std::packaged_task<Result()> task(std::forward<Func>(func));
+        auto future = task.get_future();
+        enqueue(std::move(task));
+        return future;
+    }
+
+    // blocks until every task submitted so far has finished
+    auto wait_idle() -> void;
+
+    [[nodiscard]] inline auto thread_count() const noexcept -> usize { return _threads.size(); }
+
+private:
+    auto enqueue(std::move_only_function<void()> task) -> void;
+    auto worker_loop(std::stop_token stop_token) -> void;
+
+private:
+    std::mutex _mutex;
+    std::condition_variable_any _task_available;
+    std::condition_variable _idle;
+    std::deque<std::move_only_function<void()>> _tasks{};
+    usize _busy_count = 0;
+    std::vector<std::jthread> _threads{};
+};
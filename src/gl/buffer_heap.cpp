@@ -0,0 +1,51 @@
+#include "buffer_heap.hpp"
+
+#include "gl/gl_state.hpp"
+
+BufferHeap::BufferHeap(usize block_size, GLenum usage) : _usage(usage), _block_size(block_size) {}
+
+BufferHeap::~BufferHeap() noexcept
+{
+    for (auto& block : _blocks)
+        gl_state().delete_buffer(block.id);
+}
+
+auto BufferHeap::allocate(usize size, usize alignment) -> BufferAllocation
+{
+    for (u32 i = 0; i < _blocks.size(); i++)
+    {
+        if (auto offset = _blocks[i].allocator.allocate(size, alignment))
+            return { .buffer = _blocks[i].id, .offset = *offset, .size = size, .block_index = i };
+    }
+
+    // oversized allocations get a block of their own
+    auto& block = create_block(std::max(_block_size, size));
+    auto offset = *block.allocator.allocate(size, alignment);
+    auto block_index = static_cast<u32>(_blocks.size() - 1);
+
+    return { .buffer = block.id, .offset = offset, .size = size, .block_index = block_index };
+}
+
+auto BufferHeap::free(const BufferAllocation& allocation) -> void
+{
+    _blocks[allocation.block_index].allocator.free(allocation.offset, allocation.size);
+}
+
+auto BufferHeap::upload(const BufferAllocation& allocation, const void* data, usize data_size) const noexcept
+    -> void
+{
+    gl_state().bind_buffer(GL_COPY_WRITE_BUFFER, allocation.buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(allocation.offset),
+                    static_cast<GLsizeiptr>(data_size), data);
+}
+
+auto BufferHeap::create_block(usize size) -> Block&
+{
+    GLuint id;
+    glGenBuffers(1, &id);
+    gl_state().bind_buffer(GL_COPY_WRITE_BUFFER, id);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), nullptr, _usage);
+
+    _blocks.push_back({ .id = id, .allocator = FreeListAllocator{ size } });
+    return _blocks.back();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "core/free_list_allocator.hpp"
+
+struct BufferAllocation
+{
+    GLuint buffer;
+    usize offset;
+    usize size;
+    u32 block_index;
+};
+
+// Sub-allocates many small ranges out of a few big GL buffers, so meshes don't each need their own buffer
+// object. A new block is only created when no existing one has room.
+// Blocks are created and written through GL_COPY_WRITE_BUFFER, so the heap never disturbs the vertex
+// array's element buffer binding and a block can be used with any target.
+class BufferHeap
+{
+public:
+    explicit BufferHeap(usize block_size, GLenum usage = GL_STATIC_DRAW);
+    ~BufferHeap() noexcept;
+
+    BufferHeap(const BufferHeap& other) = delete;
+    BufferHeap(BufferHeap&& other) = delete;
+
+    // alignment doesn't have to be a power of two; aligning vertex data to the vertex size makes
+    // offset / sizeof(Vertex) a valid base vertex
+    [[nodiscard]] auto allocate(usize size, usize alignment = 1) -> BufferAllocation;
+    auto free(const BufferAllocation& allocation) -> void;
+
+    // data.size_bytes() has to fit in the allocation
+    template<typename DataType>
+    inline auto upload(const BufferAllocation& allocation, std::span<DataType> data) const noexcept -> void
+    {
+        upload(allocation, data.data(), data.size_bytes());
+    }
+
+    auto upload(const BufferAllocation& allocation, const void* data, usize data_size) const noexcept -> void;
+
+    [[nodiscard]] inline auto block_count() const noexcept -> usize { return _blocks.size(); }
+    [[nodiscard]] inline auto block_id(u32 block_index) const noexcept -> GLuint
+    {
+        return _blocks[block_index].id;
+    }
+    [[nodiscard]] inline auto block_free_space(u32 block_index) const noexcept -> usize
+    {
+        return _blocks[block_index].allocator.free_space();
+    }
+
+private:
+    struct Block
+    {
+        GLuint id;
+        FreeListAllocator allocator;
+    };
+
+    auto create_block(usize size) -> Block&;
+
+private:
+    GLenum _usage;
+    usize _block_size;
+    std::vector<Block> _blocks{};
+};
@@ -0,0 +1,35 @@
+#include "compute_shader.hpp"
+
+#include "io/mapped_file.hpp"
+
+ComputeShader::ComputeShader(const ShaderPath& src_path)
+    : ComputeShader(read_single_stage_source(src_path, "compute shader").view(), src_path.string())
+{
+}
+
+ComputeShader::ComputeShader(std::string_view source, std::string_view name)
+    : Shader(create_single_stage_program(GL_COMPUTE_SHADER, source, name, false), name, "")
+{
+    std::array<GLint, 3> size{};
+    glGetProgramiv(id(), GL_COMPUTE_WORK_GROUP_SIZE, size.data());
+
+    _work_group_size = { static_cast<u32>(size[0]), static_cast<u32>(size[1]), static_cast<u32>(size[2]) };
+}
+
+auto ComputeShader::group_count_for(const glm::uvec3& invocations) const noexcept -> glm::uvec3
+{
+    return (invocations + _work_group_size - 1u) / _work_group_size;
+}
+
+auto ComputeShader::dispatch(const glm::uvec3& group_count) const noexcept -> void
+{
+    use();
+    glDispatchCompute(group_count.x, group_count.y, group_count.z);
+}
+
+auto ComputeShader::dispatch_indirect(GLuint buffer, GLintptr offset) const noexcept -> void
+{
+    use();
+    gl_state().bind_buffer(GL_DISPATCH_INDIRECT_BUFFER, buffer);
+    glDispatchComputeIndirect(offset);
+}
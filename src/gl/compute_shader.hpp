@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/shader.hpp"
+
+// layout of the commands dispatch_indirect() reads, e.g. written by a culling pass
+struct DispatchIndirectCommand
+{
+    GLuint group_count_x;
+    GLuint group_count_y;
+    GLuint group_count_z;
+};
+
+// What has to see the writes of earlier dispatches (storage buffer and image stores, atomics), for
+// memory_barrier(). Barriers only order shader writes against later reads; combine them with |.
+struct BarrierBits
+{
+    static constexpr GLbitfield storage_buffer = GL_SHADER_STORAGE_BARRIER_BIT;
+    static constexpr GLbitfield uniform_buffer = GL_UNIFORM_BARRIER_BIT;
+    static constexpr GLbitfield vertex_input =
+        GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT;
+    static constexpr GLbitfield indirect_command = GL_COMMAND_BARRIER_BIT; // draw and dispatch indirect
+    static constexpr GLbitfield texture_fetch = GL_TEXTURE_FETCH_BARRIER_BIT;
+    static constexpr GLbitfield image_access = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    // glGetBufferSubData, glMapBuffer, glCopyBufferSubData
+    static constexpr GLbitfield buffer_readback = GL_BUFFER_UPDATE_BARRIER_BIT;
+    // glGetTexImage, glReadPixels
+    static constexpr GLbitfield texture_readback =
+        GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+    static constexpr GLbitfield all = GL_ALL_BARRIER_BITS;
+};
+
+inline auto memory_barrier(GLbitfield barriers) noexcept -> void
+{
+    glMemoryBarrier(barriers);
+}
+
+// A program with a single compute stage. Uniforms, uniform blocks and storage blocks work like they do for
+// any Shader, dispatching uses the program.
+class ComputeShader : public Shader
+{
+public:
+    // throws CreateShaderError
+    explicit ComputeShader(const ShaderPath& src_path);
+    // the name is only used for error messages
+    // throws CreateShaderError
+    explicit ComputeShader(std::string_view source, std::string_view name = "<memory>");
+
+    // local_size_x, _y and _z the shader declares
+    [[nodiscard]] inline auto work_group_size() const noexcept -> const glm::uvec3&
+    {
+        return _work_group_size;
+    }
+    // work groups needed to cover every invocation, rounded up per dimension
+    [[nodiscard]] auto group_count_for(const glm::uvec3& invocations) const noexcept -> glm::uvec3;
+
+    auto dispatch(const glm::uvec3& group_count) const noexcept -> void;
+    // reads a DispatchIndirectCommand from the buffer; offset has to be a multiple of 4
+    auto dispatch_indirect(GLuint buffer, GLintptr offset = 0) const noexcept -> void;
+
+private:
+    glm::uvec3 _work_group_size;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+// A shader source compiled into the binary by tools/embed_shaders.cpp. The generated gl/embedded_shaders.hpp
+// has a table of these for every file under shaders/, indexed by EmbeddedShaderId.
+struct EmbeddedShaderSource
+{
+    std::string_view name; // the path it was embedded from, e.g. "shaders/basic.vert"
+    std::string_view source;
+};
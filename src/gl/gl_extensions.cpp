@@ -0,0 +1,58 @@
+#include "gl_extensions.hpp"
+
+static GlExtensions extensions;
+static std::set<std::string, std::less<>> extension_names;
+
+[[nodiscard]] static inline auto gl_version_at_least(int major, int minor) noexcept -> bool
+{
+    return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+template<typename Proc>
+[[nodiscard]] static inline auto load_proc_if(bool supported, GLADloadproc load_proc, const char* name)
+    -> Proc
+{
+    // some platforms (e.g. GLX) hand out non-null pointers even for unsupported functions, so the
+    // version or extension check has to come first
+    if (!supported)
+        return nullptr;
+
+    return reinterpret_cast<Proc>(load_proc(name));
+}
+
+auto load_gl_extensions(GLADloadproc load_proc) -> void
+{
+    extension_names.clear();
+
+    GLint extension_count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+
+    for (GLuint i = 0; i < static_cast<GLuint>(extension_count); i++)
+        extension_names.emplace(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)));
+
+    bool buffer_storage = gl_version_at_least(4, 4) || has_gl_extension("GL_ARB_buffer_storage");
+    extensions.buffer_storage =
+        load_proc_if<GlBufferStorageProc>(buffer_storage, load_proc, "glBufferStorage");
+
+    if (has_gl_extension("GL_KHR_parallel_shader_compile"))
+    {
+        extensions.max_shader_compiler_threads =
+            load_proc_if<GlMaxShaderCompilerThreadsProc>(true, load_proc, "glMaxShaderCompilerThreadsKHR");
+    }
+    else
+    {
+        bool arb_parallel_shader_compile = has_gl_extension("GL_ARB_parallel_shader_compile");
+        extensions.max_shader_compiler_threads = load_proc_if<GlMaxShaderCompilerThreadsProc>(
+            arb_parallel_shader_compile, load_proc, "glMaxShaderCompilerThreadsARB");
+    }
+}
+
+auto gl_extensions() noexcept -> const GlExtensions&
+{
+    return extensions;
+}
+
+auto has_gl_extension(std::string_view name) noexcept -> bool
+{
+    return extension_names.contains(name);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// The bundled glad only covers core 4.3. Entry points from newer core versions or extensions are loaded
+// here instead; each one stays null when the driver doesn't support it, so check before calling.
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+
+#ifndef GL_CLIENT_STORAGE_BIT
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+// same values for the KHR and ARB variants of parallel_shader_compile
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+using GlBufferStorageProc = void(APIENTRYP)(GLenum target, GLsizeiptr size, const void* data,
+                                            GLbitfield flags);
+using GlMaxShaderCompilerThreadsProc = void(APIENTRYP)(GLuint count);
+
+struct GlExtensions
+{
+    // GL 4.4 / ARB_buffer_storage
+    GlBufferStorageProc buffer_storage = nullptr;
+    // KHR_parallel_shader_compile or ARB_parallel_shader_compile; when set, GL_COMPLETION_STATUS_KHR can be
+    // queried on shaders and programs without blocking
+    GlMaxShaderCompilerThreadsProc max_shader_compiler_threads = nullptr;
+};
+
+// has to be called with a current context, after glad has been loaded
+auto load_gl_extensions(GLADloadproc load_proc) -> void;
+
+[[nodiscard]] auto gl_extensions() noexcept -> const GlExtensions&;
+[[nodiscard]] auto has_gl_extension(std::string_view name) noexcept -> bool;
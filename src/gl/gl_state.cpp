@@ -0,0 +1,288 @@
+#include "gl_state.hpp"
+
+#include "core/log.hpp"
+
+thread_local GlState* GlState::_current = nullptr;
+
+GlState::GlState() noexcept
+{
+    _buffers.fill(0);
+    _uniform_buffer_bindings.fill(0);
+    _storage_buffer_bindings.fill(0);
+
+    for (auto& unit : _textures)
+        unit.fill(0);
+}
+
+auto GlState::fail_no_current() noexcept -> void
+{
+    log_error("No GL state tracker is current on this thread: a GL object was used or destroyed without a "
+              "current context, e.g. after its window was destroyed or on another thread");
+    std::abort();
+}
+
+auto GlState::use_program(GLuint program) noexcept -> void
+{
+    if (update(_program, program))
+        glUseProgram(program);
+}
+
+auto GlState::bind_program_pipeline(GLuint pipeline) noexcept -> void
+{
+    use_program(0);
+
+    if (update(_program_pipeline, pipeline))
+        glBindProgramPipeline(pipeline);
+}
+
+auto GlState::bind_vertex_array(GLuint vertex_array) noexcept -> void
+{
+    if (!update(_vertex_array, vertex_array))
+        return;
+
+    glBindVertexArray(vertex_array);
+
+    // the element and vertex buffer bindings are part of the vertex array
+    _buffers[*buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)].reset();
+    _vertex_buffers.fill(std::nullopt);
+}
+
+auto GlState::bind_buffer(GLenum target, GLuint buffer) noexcept -> void
+{
+    auto index = buffer_target_index(target);
+
+    if (!index)
+    {
+        _stats.issued_calls++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (update(_buffers[*index], buffer))
+        glBindBuffer(target, buffer);
+}
+
+auto GlState::bind_buffer_base(GLenum target, u32 index, GLuint buffer) noexcept -> void
+{
+    auto bindings = indexed_buffer_bindings(target);
+
+    if (!bindings || index >= max_indexed_buffer_bindings)
+        _stats.issued_calls++;
+    else if (!update((*bindings)[index], buffer))
+        return;
+
+    glBindBufferBase(target, index, buffer);
+
+    if (auto target_index = buffer_target_index(target))
+        _buffers[*target_index] = buffer;
+}
+
+auto GlState::bind_buffer_range(GLenum target, u32 index, GLuint buffer, GLintptr offset,
+                                GLsizeiptr size) noexcept -> void
+{
+    _stats.issued_calls++;
+    glBindBufferRange(target, index, buffer, offset, size);
+
+    // the index now holds a range, a later bind_buffer_base() of the same buffer has to be issued
+    if (auto bindings = indexed_buffer_bindings(target); bindings && index < max_indexed_buffer_bindings)
+        (*bindings)[index].reset();
+
+    if (auto target_index = buffer_target_index(target))
+        _buffers[*target_index] = buffer;
+}
+
+auto GlState::bind_vertex_buffer(u32 binding_index, GLuint buffer, GLintptr offset, GLsizei stride) noexcept
+    -> void
+{
+    auto binding = GlVertexBufferBinding{ .buffer = buffer, .offset = offset, .stride = stride };
+
+    if (binding_index >= max_vertex_buffer_bindings)
+        _stats.issued_calls++;
+    else if (!update(_vertex_buffers[binding_index], binding))
+        return;
+
+    glBindVertexBuffer(binding_index, buffer, offset, stride);
+}
+
+auto GlState::active_texture(u32 unit) noexcept -> void
+{
+    if (update(_active_texture_unit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+auto GlState::bind_texture(GLenum target, GLuint texture) noexcept -> void
+{
+    auto index = texture_target_index(target);
+
+    if (!_active_texture_unit || *_active_texture_unit >= max_texture_units || !index)
+    {
+        _stats.issued_calls++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (update(_textures[*_active_texture_unit][*index], texture))
+        glBindTexture(target, texture);
+}
+
+auto GlState::bind_texture(u32 unit, GLenum target, GLuint texture) noexcept -> void
+{
+    // checked first so binding an already bound texture doesn't switch the active unit either
+    if (auto index = texture_target_index(target); index && unit < max_texture_units)
+    {
+        if (_textures[unit][*index] == texture)
+        {
+            _stats.skipped_calls++;
+            return;
+        }
+    }
+
+    active_texture(unit);
+    bind_texture(target, texture);
+}
+
+auto GlState::set_blend_enabled(bool enabled) noexcept -> void
+{
+    if (!update(_blend_enabled, enabled))
+        return;
+
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+}
+
+auto GlState::set_blend_func(GLenum source_factor, GLenum destination_factor) noexcept -> void
+{
+    if (update(_blend_func, std::pair{ source_factor, destination_factor }))
+        glBlendFunc(source_factor, destination_factor);
+}
+
+auto GlState::set_viewport(const GlViewport& viewport) noexcept -> void
+{
+    if (update(_viewport, viewport))
+        glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+}
+
+auto GlState::delete_program(GLuint program) noexcept -> void
+{
+    glDeleteProgram(program);
+
+    // a deleted program stays in use until another one is, so just stop trusting the cache
+    if (_program == program)
+        _program.reset();
+}
+
+auto GlState::delete_program_pipeline(GLuint pipeline) noexcept -> void
+{
+    glDeleteProgramPipelines(1, &pipeline);
+
+    if (_program_pipeline == pipeline)
+        _program_pipeline = 0;
+}
+
+auto GlState::delete_vertex_array(GLuint vertex_array) noexcept -> void
+{
+    glDeleteVertexArrays(1, &vertex_array);
+
+    if (_vertex_array == vertex_array)
+    {
+        _vertex_array = 0;
+        _buffers[*buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)].reset();
+        _vertex_buffers.fill(std::nullopt);
+    }
+}
+
+auto GlState::delete_buffer(GLuint buffer) noexcept -> void
+{
+    glDeleteBuffers(1, &buffer);
+
+    for (auto* bindings : { &_uniform_buffer_bindings, &_storage_buffer_bindings })
+    {
+        for (auto& binding : *bindings)
+        {
+            if (binding == buffer)
+                binding = 0;
+        }
+    }
+
+    for (auto& binding : _buffers)
+    {
+        if (binding == buffer)
+            binding = 0;
+    }
+
+    // GL detaches it from the bound vertex array, with the offset and stride left as they were
+    for (auto& binding : _vertex_buffers)
+    {
+        if (binding && binding->buffer == buffer)
+            binding.reset();
+    }
+}
+
+auto GlState::delete_texture(GLuint texture) noexcept -> void
+{
+    glDeleteTextures(1, &texture);
+
+    for (auto& unit : _textures)
+    {
+        for (auto& binding : unit)
+        {
+            if (binding == texture)
+                binding = 0;
+        }
+    }
+}
+
+auto GlState::invalidate() noexcept -> void
+{
+    _program.reset();
+    _program_pipeline.reset();
+    _vertex_array.reset();
+    _buffers.fill(std::nullopt);
+    _uniform_buffer_bindings.fill(std::nullopt);
+    _storage_buffer_bindings.fill(std::nullopt);
+    _vertex_buffers.fill(std::nullopt);
+    _active_texture_unit.reset();
+
+    for (auto& unit : _textures)
+        unit.fill(std::nullopt);
+
+    _blend_enabled.reset();
+    _blend_func.reset();
+    _viewport.reset();
+}
+
+auto GlState::buffer_target_index(GLenum target) noexcept -> std::optional<usize>
+{
+    auto found = std::ranges::find(_tracked_buffer_targets, target);
+
+    if (found == _tracked_buffer_targets.end())
+        return std::nullopt;
+
+    return static_cast<usize>(found - _tracked_buffer_targets.begin());
+}
+
+auto GlState::texture_target_index(GLenum target) noexcept -> std::optional<usize>
+{
+    auto found = std::ranges::find(_tracked_texture_targets, target);
+
+    if (found == _tracked_texture_targets.end())
+        return std::nullopt;
+
+    return static_cast<usize>(found - _tracked_texture_targets.begin());
+}
+
+auto GlState::indexed_buffer_bindings(GLenum target) noexcept
+    -> std::array<std::optional<GLuint>, max_indexed_buffer_bindings>*
+{
+    switch (target)
+    {
+    case GL_UNIFORM_BUFFER:
+        return &_uniform_buffer_bindings;
+    case GL_SHADER_STORAGE_BUFFER:
+        return &_storage_buffer_bindings;
+    default:
+        return nullptr;
+    }
+}
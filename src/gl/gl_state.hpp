@@ -0,0 +1,157 @@
+#pragma once
+
+#include <glad/glad.h>
+
+struct GlStateStats
+{
+    u64 issued_calls = 0;
+    u64 skipped_calls = 0;
+};
+
+struct GlVertexBufferBinding
+{
+    GLuint buffer;
+    GLintptr offset;
+    GLsizei stride;
+
+    auto operator==(const GlVertexBufferBinding& other) const noexcept -> bool = default;
+};
+
+struct GlViewport
+{
+    GLint x;
+    GLint y;
+    GLsizei width;
+    GLsizei height;
+
+    auto operator==(const GlViewport& other) const noexcept -> bool = default;
+};
+
+// Shadows the bindings of one GL context and drops calls that wouldn't change anything. Every bind in
+// the renderer goes through the tracker of the context current on the calling thread, see gl_state().
+//
+// Anything that changes this state with raw GL calls has to invalidate() the tracker afterwards, and
+// objects have to be deleted through it, since deleting a bound object silently unbinds it.
+// Buffer targets and texture targets the tracker doesn't know are passed through and always issued.
+class GlState
+{
+public:
+    static constexpr u32 max_texture_units = 32;
+    // GL guarantees at least 84 uniform buffer and 8 storage buffer bindings, higher ones aren't tracked
+    static constexpr u32 max_indexed_buffer_bindings = 32;
+    // the minimum of GL_MAX_VERTEX_ATTRIB_BINDINGS, higher ones aren't tracked
+    static constexpr u32 max_vertex_buffer_bindings = 16;
+
+    // for a fresh context
+    GlState() noexcept;
+
+    GlState(const GlState& other) = delete;
+    GlState(GlState&& other) = delete;
+
+    auto use_program(GLuint program) noexcept -> void;
+    // a program in use overrides the pipeline, so this also stops using it
+    auto bind_program_pipeline(GLuint pipeline) noexcept -> void;
+    auto bind_vertex_array(GLuint vertex_array) noexcept -> void;
+    auto bind_buffer(GLenum target, GLuint buffer) noexcept -> void;
+    // indexed binding of a whole buffer, also binds it to the generic target like GL does
+    auto bind_buffer_base(GLenum target, u32 index, GLuint buffer) noexcept -> void;
+    // always issued, ranges aren't tracked
+    auto bind_buffer_range(GLenum target, u32 index, GLuint buffer, GLintptr offset, GLsizeiptr size) noexcept
+        -> void;
+    // glBindVertexBuffer; like the element buffer, this is part of the bound vertex array and forgotten when
+    // another one is bound
+    auto bind_vertex_buffer(u32 binding_index, GLuint buffer, GLintptr offset, GLsizei stride) noexcept
+        -> void;
+    auto active_texture(u32 unit) noexcept -> void;
+    // binds to the active texture unit
+    auto bind_texture(GLenum target, GLuint texture) noexcept -> void;
+    auto bind_texture(u32 unit, GLenum target, GLuint texture) noexcept -> void;
+    auto set_blend_enabled(bool enabled) noexcept -> void;
+    auto set_blend_func(GLenum source_factor, GLenum destination_factor) noexcept -> void;
+    auto set_viewport(const GlViewport& viewport) noexcept -> void;
+
+    auto delete_program(GLuint program) noexcept -> void;
+    auto delete_program_pipeline(GLuint pipeline) noexcept -> void;
+    auto delete_vertex_array(GLuint vertex_array) noexcept -> void;
+    auto delete_buffer(GLuint buffer) noexcept -> void;
+    auto delete_texture(GLuint texture) noexcept -> void;
+
+    // forgets everything, the next call of each kind is issued again
+    auto invalidate() noexcept -> void;
+
+    [[nodiscard]] inline auto stats() const noexcept -> const GlStateStats& { return _stats; }
+    inline auto reset_stats() noexcept -> void { _stats = {}; }
+
+    // the tracker of the context current on this thread, set by GlWindow::make_context_current()
+    [[nodiscard]] static inline auto current() noexcept -> GlState* { return _current; }
+    static inline auto make_current(GlState* state) noexcept -> void { _current = state; }
+    // logs which call had no tracker and aborts, see gl_state()
+    [[noreturn]] static auto fail_no_current() noexcept -> void;
+
+private:
+    [[nodiscard]] static auto buffer_target_index(GLenum target) noexcept -> std::optional<usize>;
+    [[nodiscard]] static auto texture_target_index(GLenum target) noexcept -> std::optional<usize>;
+    // nullptr for targets without tracked indexed bindings
+    [[nodiscard]] auto indexed_buffer_bindings(GLenum target) noexcept
+        -> std::array<std::optional<GLuint>, max_indexed_buffer_bindings>*;
+
+    // records the new value and returns true if the GL call has to be made
+    template<typename T> [[nodiscard]] inline auto update(std::optional<T>& cached, const T& value) noexcept
+        -> bool
+    {
+        if (cached == value)
+        {
+            _stats.skipped_calls++;
+            return false;
+        }
+
+        cached = value;
+        _stats.issued_calls++;
+        return true;
+    }
+
+private:
+    static constexpr std::array<GLenum, 10> _tracked_buffer_targets = {
+        GL_ARRAY_BUFFER,         GL_ELEMENT_ARRAY_BUFFER,     GL_COPY_READ_BUFFER,  GL_COPY_WRITE_BUFFER,
+        GL_PIXEL_PACK_BUFFER,    GL_PIXEL_UNPACK_BUFFER,      GL_UNIFORM_BUFFER,    GL_SHADER_STORAGE_BUFFER,
+        GL_DRAW_INDIRECT_BUFFER, GL_DISPATCH_INDIRECT_BUFFER,
+    };
+
+    static constexpr std::array<GLenum, 4> _tracked_texture_targets = {
+        GL_TEXTURE_2D,
+        GL_TEXTURE_2D_ARRAY,
+        GL_TEXTURE_3D,
+        GL_TEXTURE_CUBE_MAP,
+    };
+
+    // nullopt means unknown; a fresh context has everything unbound and blending disabled
+    std::optional<GLuint> _program = 0;
+    std::optional<GLuint> _program_pipeline = 0;
+    std::optional<GLuint> _vertex_array = 0;
+    std::array<std::optional<GLuint>, _tracked_buffer_targets.size()> _buffers{};
+    std::array<std::optional<GLuint>, max_indexed_buffer_bindings> _uniform_buffer_bindings{};
+    std::array<std::optional<GLuint>, max_indexed_buffer_bindings> _storage_buffer_bindings{};
+    std::array<std::optional<GlVertexBufferBinding>, max_vertex_buffer_bindings> _vertex_buffers{};
+    std::optional<u32> _active_texture_unit = 0;
+    std::array<std::array<std::optional<GLuint>, _tracked_texture_targets.size()>, max_texture_units>
+        _textures{};
+    std::optional<bool> _blend_enabled = false;
+    std::optional<std::pair<GLenum, GLenum>> _blend_func = std::pair<GLenum, GLenum>{ GL_ONE, GL_ZERO };
+    std::optional<GlViewport> _viewport{};
+    GlStateStats _stats{};
+
+    static thread_local GlState* _current;
+};
+
+// There has to be a current tracker, otherwise this aborts with a message instead of crashing somewhere
+// in the driver. That happens when GL objects outlive their window, or on threads whose context wasn't made
+// current through GlWindow.
+[[nodiscard]] inline auto gl_state() noexcept -> GlState&
+{
+    auto state = GlState::current();
+
+    if (!state) [[unlikely]]
+        GlState::fail_no_current();
+
+    return *state;
+}
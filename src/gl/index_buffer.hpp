@@ -2,6 +2,28 @@
 
 #include <glad/glad.h>
 
+#include "gl/gl_state.hpp"
+
+template<typename IndexType> constexpr inline auto get_index_type() -> GLenum
+{
+    static_assert(false, "not implemented");
+}
+
+template<> constexpr inline auto get_index_type<GLubyte>() -> GLenum
+{
+    return GL_UNSIGNED_BYTE;
+}
+
+template<> constexpr inline auto get_index_type<GLushort>() -> GLenum
+{
+    return GL_UNSIGNED_SHORT;
+}
+
+template<> constexpr inline auto get_index_type<GLuint>() -> GLenum
+{
+    return GL_UNSIGNED_INT;
+}
+
 class IndexBuffer
 {
 public:
@@ -33,7 +55,7 @@ public:
         buffer_data(data, usage);
     }
 
-    inline ~IndexBuffer() noexcept { glDeleteBuffers(1, &_id); }
+    inline ~IndexBuffer() noexcept { gl_state().delete_buffer(_id); }
 
     IndexBuffer(const IndexBuffer& other) = delete;
     IndexBuffer(IndexBuffer&& other) = delete;
@@ -58,7 +80,7 @@ public:
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.size_bytes()), data.data(), usage);
     }
 
-    inline auto bind() const noexcept -> void { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _id); }
+    inline auto bind() const noexcept -> void { gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _id); }
     [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
 
 private:
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/gl_state.hpp"
+#include "gl/index_buffer.hpp"
+#include "gl/vertex_array.hpp"
+#include "gl/vertex_buffer.hpp"
+#include "gl/vertex_buffer_layout.hpp"
+
+// One mesh drawn many times with a single glDrawElementsInstanced, instead of a draw call and uniform updates
+// per copy. Per-instance data lives in a second vertex buffer; its attributes come after the vertex
+// attributes' locations and advance once per instance, see bind_instanced_vertex_buffer_layout.
+template<typename VertexType, typename InstanceType, typename IndexType = GLushort> class InstancedMesh
+{
+public:
+    explicit InstancedMesh(std::span<const VertexType> vertices, std::span<const IndexType> indices,
+                           usize instance_capacity = 0)
+        : _vertex_buffer(vertices, GL_STATIC_DRAW),
+          // creating the index buffer binds it to the bound vertex array, which has to be this mesh's
+          _index_buffer((_vertex_array.bind(), indices), GL_STATIC_DRAW),
+          _index_count(static_cast<GLsizei>(indices.size())),
+          _instance_capacity(instance_capacity)
+    {
+        _instance_buffer.bind();
+        _instance_buffer.buffer_data(nullptr, _instance_capacity * sizeof(InstanceType), GL_STREAM_DRAW);
+
+        _vertex_array.bind();
+        _index_buffer.bind();
+        bind_instanced_vertex_buffer_layout<VertexType, InstanceType>(_vertex_buffer.id(),
+                                                                      _instance_buffer.id());
+    }
+
+    InstancedMesh(const InstancedMesh& other) = delete;
+    InstancedMesh(InstancedMesh&& other) = delete;
+
+    // Replaces all instances. The buffer is reallocated each time, so the driver can hand out fresh memory
+    // instead of waiting for draws still reading the old contents; it only grows.
+    auto set_instances(std::span<const InstanceType> instances) noexcept -> void
+    {
+        _instance_capacity = std::max(_instance_capacity, instances.size());
+        _instance_count = static_cast<GLsizei>(instances.size());
+
+        _instance_buffer.bind();
+        _instance_buffer.buffer_data(nullptr, _instance_capacity * sizeof(InstanceType), GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(instances.size_bytes()),
+                        instances.data());
+    }
+
+    // every instance in a single draw call
+    inline auto draw() const noexcept -> void { draw(0, _instance_count); }
+
+    // instances [first_instance, first_instance + instance_count) in a single draw call
+    inline auto draw(GLuint first_instance, GLsizei instance_count) const noexcept -> void
+    {
+        _vertex_array.bind();
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, _index_count, get_index_type<IndexType>(), nullptr,
+                                            instance_count, first_instance);
+    }
+
+    [[nodiscard]] inline auto instance_count() const noexcept -> GLsizei { return _instance_count; }
+    [[nodiscard]] inline auto instance_capacity() const noexcept -> usize { return _instance_capacity; }
+
+private:
+    VertexArray _vertex_array{}; // constructed first, see the constructor
+    VertexBuffer _vertex_buffer;
+    IndexBuffer _index_buffer;
+    VertexBuffer _instance_buffer{};
+    GLsizei _index_count;
+    GLsizei _instance_count = 0;
+    usize _instance_capacity;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/buffer_heap.hpp"
+#include "gl/gl_state.hpp"
+#include "gl/index_buffer.hpp"
+#include "gl/vertex_array.hpp"
+#include "gl/vertex_buffer_layout.hpp"
+
+struct MeshHandle
+{
+    BufferAllocation vertices;
+    BufferAllocation indices;
+    GLint base_vertex;
+    GLsizei index_count;
+};
+
+// Many meshes of one vertex type in shared vertex and index buffers. Every mesh shares a single vertex array
+// whose format is declared once; drawing one attaches the blocks it lives in, which GlState skips while they
+// stay the same, and is a single glDrawElementsBaseVertex with the mesh's offsets.
+template<typename VertexType, typename IndexType = GLushort> class MeshHeap
+{
+public:
+    static constexpr usize default_vertex_block_size = 4 * 1024 * 1024;
+    static constexpr usize default_index_block_size = 1024 * 1024;
+
+    explicit MeshHeap(usize vertex_block_size = default_vertex_block_size,
+                      usize index_block_size = default_index_block_size)
+        : _vertex_heap(vertex_block_size), _index_heap(index_block_size)
+    {
+        set_vertex_format<VertexType>(vertex_buffer_binding);
+    }
+
+    MeshHeap(const MeshHeap& other) = delete;
+    MeshHeap(MeshHeap&& other) = delete;
+
+    [[nodiscard]] auto add(std::span<const VertexType> vertices, std::span<const IndexType> indices)
+        -> MeshHandle
+    {
+        // aligned to the vertex size, so the offset is a whole number of vertices
+        auto vertex_allocation = _vertex_heap.allocate(vertices.size_bytes(), sizeof(VertexType));
+        auto index_allocation = _index_heap.allocate(indices.size_bytes(), sizeof(IndexType));
+
+        _vertex_heap.upload(vertex_allocation, vertices);
+        _index_heap.upload(index_allocation, indices);
+
+        return {
+            .vertices = vertex_allocation,
+            .indices = index_allocation,
+            .base_vertex = static_cast<GLint>(vertex_allocation.offset / sizeof(VertexType)),
+            .index_count = static_cast<GLsizei>(indices.size()),
+        };
+    }
+
+    auto remove(const MeshHandle& mesh) -> void
+    {
+        _vertex_heap.free(mesh.vertices);
+        _index_heap.free(mesh.indices);
+    }
+
+    auto draw(const MeshHandle& mesh, GLenum mode = GL_TRIANGLES) const noexcept -> void
+    {
+        bind_vertex_array(mesh);
+        glDrawElementsBaseVertex(mode, mesh.index_count, get_index_type<IndexType>(),
+                                 reinterpret_cast<const void*>(mesh.indices.offset), mesh.base_vertex);
+    }
+
+    // binds the shared vertex array with the blocks the mesh lives in attached
+    auto bind_vertex_array(const MeshHandle& mesh) const noexcept -> void
+    {
+        _vertex_array.bind();
+        gl_state().bind_vertex_buffer(vertex_buffer_binding, mesh.vertices.buffer, 0, sizeof(VertexType));
+        gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.buffer);
+    }
+
+    [[nodiscard]] inline auto vertex_heap() const noexcept -> const BufferHeap& { return _vertex_heap; }
+    [[nodiscard]] inline auto index_heap() const noexcept -> const BufferHeap& { return _index_heap; }
+
+private:
+    static constexpr GLuint vertex_buffer_binding = 0;
+
+    // declared first, the constructor sets the vertex format on it while it's bound
+    VertexArray _vertex_array{};
+    BufferHeap _vertex_heap;
+    BufferHeap _index_heap;
+};
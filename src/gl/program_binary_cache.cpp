@@ -0,0 +1,214 @@
+#include "program_binary_cache.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include "core/hash.hpp"
+#include "core/log.hpp"
+#include "gl/shader.hpp"
+#include "io/mapped_file.hpp"
+
+static constexpr u32 program_binary_magic = 0x4250'4c47; // "GLPB"
+static constexpr u32 program_binary_version = 1;
+
+struct ProgramBinaryHeader
+{
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 binary_format;
+    u32 binary_size;
+    u64 checksum; // FNV-1a of the binary
+};
+
+static_assert(sizeof(ProgramBinaryHeader) == 32);
+
+[[nodiscard]] static inline auto get_gl_string(GLenum name) noexcept -> std::string_view
+{
+    auto string = glGetString(name);
+    return string ? reinterpret_cast<const char*>(string) : "";
+}
+
+ProgramBinaryCache::ProgramBinaryCache(std::filesystem::path directory) : _directory(std::move(directory))
+{
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+
+    if (error) [[unlikely]]
+        log_warning("Can't create program binary cache directory {}: {}", _directory.string(),
+                    error.message());
+
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+
+    if (format_count > 0)
+    {
+        std::vector<GLint> formats(static_cast<usize>(format_count));
+        glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+        std::ranges::transform(formats, std::back_inserter(_binary_formats),
+                               [](GLint format) { return static_cast<GLenum>(format); });
+    }
+
+    _driver_hash = fnv1a_64(get_gl_string(GL_VENDOR));
+    _driver_hash = fnv1a_64(get_gl_string(GL_RENDERER), _driver_hash);
+    _driver_hash = fnv1a_64(get_gl_string(GL_VERSION), _driver_hash);
+    _driver_hash = fnv1a_64(std::as_bytes(std::span{ _binary_formats }), _driver_hash);
+}
+
+auto ProgramBinaryCache::make_key(const ShaderSources& sources, std::string_view defines) const noexcept
+    -> u64
+{
+    // separators keep e.g. moving a line from the end of one stage to the start of the next from colliding
+    constexpr std::string_view separator{ "\0", 1 };
+
+    u64 key = _driver_hash;
+
+    for (auto part : { defines, sources.vertex, sources.fragment })
+    {
+        key = fnv1a_64(part, key);
+        key = fnv1a_64(separator, key);
+    }
+
+    return key;
+}
+
+auto ProgramBinaryCache::load(u64 key) const -> GLuint
+{
+    if (!is_supported())
+        return 0;
+
+    auto path = file_path(key);
+    std::error_code error;
+
+    if (!std::filesystem::exists(path, error))
+        return 0;
+
+    std::optional<ProgramBinaryHeader> header;
+    std::vector<std::byte> binary;
+
+    // copied out, so the file is closed again before it might get discarded
+    try
+    {
+        MappedFile file(path);
+        auto bytes = file.bytes();
+
+        if (bytes.size() >= sizeof(ProgramBinaryHeader))
+        {
+            header.emplace();
+            std::memcpy(&*header, bytes.data(), sizeof(ProgramBinaryHeader));
+            binary.assign(bytes.begin() + sizeof(ProgramBinaryHeader), bytes.end());
+        }
+    }
+    catch (FileIoError& e)
+    {
+        log_warning("Can't read program binary {}: {}", path.string(), e.what());
+        return 0;
+    }
+
+    if (!header) [[unlikely]]
+    {
+        discard(key, "file is truncated");
+        return 0;
+    }
+
+    if (header->magic != program_binary_magic || header->version != program_binary_version
+        || header->key != key) [[unlikely]]
+    {
+        discard(key, "header doesn't match");
+        return 0;
+    }
+
+    if (binary.size() != header->binary_size || fnv1a_64(binary) != header->checksum) [[unlikely]]
+    {
+        discard(key, "checksum doesn't match");
+        return 0;
+    }
+
+    if (std::ranges::find(_binary_formats, header->binary_format) == _binary_formats.end()) [[unlikely]]
+    {
+        discard(key, "binary format isn't supported by the driver");
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header->binary_format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+    if (success == GL_FALSE) [[unlikely]]
+    {
+        glDeleteProgram(program);
+        discard(key, "rejected by the driver");
+        return 0;
+    }
+
+    return program;
+}
+
+auto ProgramBinaryCache::store(u64 key, GLuint program) const -> void
+{
+    if (!is_supported())
+        return;
+
+    GLint binary_length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+
+    if (binary_length <= 0) [[unlikely]]
+    {
+        log_warning("Can't store program binary: program {} has no binary, was it linked retrievable?",
+                    program);
+        return;
+    }
+
+    std::vector<std::byte> binary(static_cast<usize>(binary_length));
+    GLenum binary_format = 0;
+    glGetProgramBinary(program, binary_length, &binary_length, &binary_format, binary.data());
+    binary.resize(static_cast<usize>(binary_length));
+
+    ProgramBinaryHeader header = {
+        .magic = program_binary_magic,
+        .version = program_binary_version,
+        .key = key,
+        .binary_format = binary_format,
+        .binary_size = static_cast<u32>(binary.size()),
+        .checksum = fnv1a_64(binary),
+    };
+
+    // written next to the final file and renamed, so a crash mid-write never leaves a torn file behind
+    auto path = file_path(key);
+    auto temporary_path = path;
+    temporary_path += ".tmp";
+
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+
+        if (!file) [[unlikely]]
+        {
+            log_warning("Can't write program binary {}", temporary_path.string());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+
+    if (error) [[unlikely]]
+        log_warning("Can't write program binary {}: {}", path.string(), error.message());
+}
+
+auto ProgramBinaryCache::file_path(u64 key) const -> std::filesystem::path
+{
+    return _directory / std::format("{:016x}.bin", key);
+}
+
+auto ProgramBinaryCache::discard(u64 key, std::string_view reason) const -> void
+{
+    auto path = file_path(key);
+    log_warning("Discarding program binary {}: {}", path.string(), reason);
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
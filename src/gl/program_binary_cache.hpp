@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <filesystem>
+
+struct ShaderSources;
+
+// On-disk cache of linked program binaries (GL 4.1 / ARB_get_program_binary), one file per program.
+//
+// Keys cover the shader sources and the driver: vendor, renderer and version strings and the binary
+// formats it supports, so updating the driver or switching GPUs just misses. A file that's truncated, fails
+// its checksum or is rejected by glProgramBinary is deleted and reported as a miss, and the caller falls
+// back to compiling from source.
+//
+// Needs a current context; all calls have to happen on its thread.
+class ProgramBinaryCache
+{
+public:
+    // creates the directory if needed
+    explicit ProgramBinaryCache(std::filesystem::path directory);
+
+    ProgramBinaryCache(const ProgramBinaryCache& other) = delete;
+    ProgramBinaryCache(ProgramBinaryCache&& other) = delete;
+
+    // defines have to be passed separately if they're not already part of the sources
+    [[nodiscard]] auto make_key(const ShaderSources& sources, std::string_view defines = {}) const noexcept
+        -> u64;
+
+    // returns a linked program, or 0 on a miss
+    [[nodiscard]] auto load(u64 key) const -> GLuint;
+    // the program has to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set; failing to write the file
+    // is only logged, the cache is an optimization
+    auto store(u64 key, GLuint program) const -> void;
+
+    // false if the driver supports no binary formats, load() then always misses and store() does nothing
+    [[nodiscard]] inline auto is_supported() const noexcept -> bool { return !_binary_formats.empty(); }
+    [[nodiscard]] inline auto directory() const noexcept -> const std::filesystem::path&
+    {
+        return _directory;
+    }
+
+private:
+    [[nodiscard]] auto file_path(u64 key) const -> std::filesystem::path;
+    // deletes a file that can't be used, so it gets rewritten by the next store()
+    auto discard(u64 key, std::string_view reason) const -> void;
+
+private:
+    std::filesystem::path _directory;
+    std::vector<GLenum> _binary_formats{};
+    u64 _driver_hash;
+};
@@ -0,0 +1,88 @@
+#include "program_pipeline.hpp"
+
+#include "core/log.hpp"
+#include "io/mapped_file.hpp"
+
+// throws CreateShaderError
+[[nodiscard]] static auto check_stage_type(GLenum shader_type, std::string_view name) -> GLenum
+{
+    if (shader_type != GL_VERTEX_SHADER && shader_type != GL_FRAGMENT_SHADER) [[unlikely]]
+    {
+        auto message = std::format("Can't create shader stage {}: type {:#x} isn't a vertex or fragment "
+                                   "shader",
+                                   name, shader_type);
+        log_error("{}", message);
+        throw CreateShaderError{ message };
+    }
+
+    return shader_type;
+}
+
+ShaderStage::ShaderStage(GLenum shader_type, const ShaderPath& src_path)
+    : ShaderStage(shader_type, read_single_stage_source(src_path, "shader stage").view(), src_path.string())
+{
+}
+
+ShaderStage::ShaderStage(GLenum shader_type, std::string_view source, std::string_view name)
+    : Shader(create_single_stage_program(check_stage_type(shader_type, name), source, name, true),
+             shader_type == GL_VERTEX_SHADER ? name : "", shader_type == GL_FRAGMENT_SHADER ? name : ""),
+      _type(shader_type)
+{
+}
+
+ProgramPipeline::ProgramPipeline(const ShaderStage& vertex_stage, const ShaderStage& fragment_stage)
+{
+    // swapped stages would make a pipeline without a vertex stage, which draws nothing without an error
+    if (vertex_stage.type() != GL_VERTEX_SHADER || fragment_stage.type() != GL_FRAGMENT_SHADER) [[unlikely]]
+    {
+        auto message = std::format("Can't create program pipeline: programs {} and {} aren't a vertex and a "
+                                   "fragment stage",
+                                   vertex_stage.id(), fragment_stage.id());
+        log_error("{}", message);
+        throw CreateShaderError{ message };
+    }
+
+    glGenProgramPipelines(1, &_id);
+    glUseProgramStages(_id, GL_VERTEX_SHADER_BIT, vertex_stage.id());
+    glUseProgramStages(_id, GL_FRAGMENT_SHADER_BIT, fragment_stage.id());
+
+#ifdef _DEBUG
+    // catches mismatched interfaces between the stages, which linking would have
+    glValidateProgramPipeline(_id);
+
+    GLint valid = GL_FALSE;
+    glGetProgramPipelineiv(_id, GL_VALIDATE_STATUS, &valid);
+
+    if (valid == GL_FALSE) [[unlikely]]
+    {
+        GLint log_length = 0;
+        glGetProgramPipelineiv(_id, GL_INFO_LOG_LENGTH, &log_length);
+        std::vector<GLchar> error_log(static_cast<usize>(std::max(log_length, 1)));
+        glGetProgramPipelineInfoLog(_id, static_cast<GLsizei>(error_log.size()), nullptr, error_log.data());
+
+        log_warning("Warning: Program pipeline {} (programs {}, {}) isn't valid: {}", _id, vertex_stage.id(),
+                    fragment_stage.id(), error_log.data());
+    }
+#endif
+}
+
+auto ProgramPipelineCache::get(const ShaderStage& vertex_stage, const ShaderStage& fragment_stage)
+    -> const ProgramPipeline&
+{
+    auto key = make_key(vertex_stage.id(), fragment_stage.id());
+
+    if (auto pipeline = _pipelines.find(key); pipeline != _pipelines.end()) [[likely]]
+        return *pipeline->second;
+
+    // created before it's inserted, a pipeline that can't be created doesn't leave an empty entry behind
+    auto pipeline = std::make_unique<ProgramPipeline>(vertex_stage, fragment_stage);
+    return *_pipelines.emplace(key, std::move(pipeline)).first->second;
+}
+
+auto ProgramPipelineCache::remove(const ShaderStage& stage) noexcept -> void
+{
+    std::erase_if(_pipelines, [&](const auto& entry) {
+        auto program = stage.id();
+        return entry.first >> 32 == program || (entry.first & 0xffffffff) == program;
+    });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/shader.hpp"
+
+// A separable program with a single vertex or fragment stage, to be combined with others through a
+// ProgramPipeline instead of being linked with each of them. Uniforms and blocks work like for any Shader,
+// but don't use() a stage, bind a pipeline containing it.
+//
+// Stages are matched by interface location, so outputs and inputs between them need layout(location = n),
+// and the vertex stage has to redeclare "out gl_PerVertex { vec4 gl_Position; };".
+class ShaderStage : public Shader
+{
+public:
+    // shader_type is GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+    // throws CreateShaderError, also for other shader types
+    explicit ShaderStage(GLenum shader_type, const ShaderPath& src_path);
+    // the name is only used for error messages
+    // throws CreateShaderError, also for other shader types
+    explicit ShaderStage(GLenum shader_type, std::string_view source, std::string_view name = "<memory>");
+
+    [[nodiscard]] inline auto type() const noexcept -> GLenum { return _type; }
+
+private:
+    GLenum _type;
+};
+
+class ProgramPipeline
+{
+public:
+    // validation failures are only logged, in debug builds
+    // throws CreateShaderError if the stages aren't a vertex and a fragment stage, in that order
+    explicit ProgramPipeline(const ShaderStage& vertex_stage, const ShaderStage& fragment_stage);
+    inline ~ProgramPipeline() noexcept { gl_state().delete_program_pipeline(_id); }
+
+    ProgramPipeline(const ProgramPipeline& other) = delete;
+    ProgramPipeline(ProgramPipeline&& other) = delete;
+
+    inline auto bind() const noexcept -> void { gl_state().bind_program_pipeline(_id); }
+    [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
+
+private:
+    GLuint _id;
+};
+
+// One pipeline per combination of stages, created on first use. N vertex and M fragment variants cost N + M
+// compiles and cheap pipeline objects, instead of N * M program links.
+//
+// Pipelines are keyed by the stages' program ids, which GL reuses after deleting a program; remove() the
+// stage from the cache before destroying it.
+class ProgramPipelineCache
+{
+public:
+    // throws CreateShaderError if the stages aren't a vertex and a fragment stage, in that order
+    [[nodiscard]] auto get(const ShaderStage& vertex_stage, const ShaderStage& fragment_stage)
+        -> const ProgramPipeline&;
+    // drops every pipeline using the stage
+    auto remove(const ShaderStage& stage) noexcept -> void;
+
+    [[nodiscard]] inline auto size() const noexcept -> usize { return _pipelines.size(); }
+    inline auto clear() noexcept -> void { _pipelines.clear(); }
+
+private:
+    [[nodiscard]] static inline auto make_key(GLuint vertex_program, GLuint fragment_program) noexcept -> u64
+    {
+        return static_cast<u64>(vertex_program) << 32 | fragment_program;
+    }
+
+private:
+    std::unordered_map<u64, std::unique_ptr<ProgramPipeline>> _pipelines{};
+};
@@ -1,47 +1,338 @@
 #include "shader.hpp"
 
 #include "core/log.hpp"
-#include "io/file_io.hpp"
+#include "gl/program_binary_cache.hpp"
+#include "io/asset_archive.hpp"
+#include "io/mapped_file.hpp"
 
 static constexpr GLuint invalid_shader_id = 0;
 static constexpr GLuint invalid_shader_program_id = 0;
 
-static auto delete_shader_if_invalid(GLuint id) noexcept -> void
+// GL reports arrays as "name[0]"
+static constexpr std::string_view array_suffix = "[0]";
+
+// every opaque type GL 4.3 core has besides atomic counters, table 7.3 of the spec
+static constexpr auto sampler_and_image_types = std::to_array<GLenum>({
+    // float samplers
+    GL_SAMPLER_1D,
+    GL_SAMPLER_2D,
+    GL_SAMPLER_3D,
+    GL_SAMPLER_CUBE,
+    GL_SAMPLER_1D_SHADOW,
+    GL_SAMPLER_2D_SHADOW,
+    GL_SAMPLER_1D_ARRAY,
+    GL_SAMPLER_2D_ARRAY,
+    GL_SAMPLER_CUBE_MAP_ARRAY,
+    GL_SAMPLER_1D_ARRAY_SHADOW,
+    GL_SAMPLER_2D_ARRAY_SHADOW,
+    GL_SAMPLER_2D_MULTISAMPLE,
+    GL_SAMPLER_2D_MULTISAMPLE_ARRAY,
+    GL_SAMPLER_CUBE_SHADOW,
+    GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW,
+    GL_SAMPLER_BUFFER,
+    GL_SAMPLER_2D_RECT,
+    GL_SAMPLER_2D_RECT_SHADOW,
+
+    // integer samplers
+    GL_INT_SAMPLER_1D,
+    GL_INT_SAMPLER_2D,
+    GL_INT_SAMPLER_3D,
+    GL_INT_SAMPLER_CUBE,
+    GL_INT_SAMPLER_1D_ARRAY,
+    GL_INT_SAMPLER_2D_ARRAY,
+    GL_INT_SAMPLER_CUBE_MAP_ARRAY,
+    GL_INT_SAMPLER_2D_MULTISAMPLE,
+    GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY,
+    GL_INT_SAMPLER_BUFFER,
+    GL_INT_SAMPLER_2D_RECT,
+    GL_UNSIGNED_INT_SAMPLER_1D,
+    GL_UNSIGNED_INT_SAMPLER_2D,
+    GL_UNSIGNED_INT_SAMPLER_3D,
+    GL_UNSIGNED_INT_SAMPLER_CUBE,
+    GL_UNSIGNED_INT_SAMPLER_1D_ARRAY,
+    GL_UNSIGNED_INT_SAMPLER_2D_ARRAY,
+    GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY,
+    GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE,
+    GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY,
+    GL_UNSIGNED_INT_SAMPLER_BUFFER,
+    GL_UNSIGNED_INT_SAMPLER_2D_RECT,
+
+    // images
+    GL_IMAGE_1D,
+    GL_IMAGE_2D,
+    GL_IMAGE_3D,
+    GL_IMAGE_2D_RECT,
+    GL_IMAGE_CUBE,
+    GL_IMAGE_BUFFER,
+    GL_IMAGE_1D_ARRAY,
+    GL_IMAGE_2D_ARRAY,
+    GL_IMAGE_CUBE_MAP_ARRAY,
+    GL_IMAGE_2D_MULTISAMPLE,
+    GL_IMAGE_2D_MULTISAMPLE_ARRAY,
+    GL_INT_IMAGE_1D,
+    GL_INT_IMAGE_2D,
+    GL_INT_IMAGE_3D,
+    GL_INT_IMAGE_2D_RECT,
+    GL_INT_IMAGE_CUBE,
+    GL_INT_IMAGE_BUFFER,
+    GL_INT_IMAGE_1D_ARRAY,
+    GL_INT_IMAGE_2D_ARRAY,
+    GL_INT_IMAGE_CUBE_MAP_ARRAY,
+    GL_INT_IMAGE_2D_MULTISAMPLE,
+    GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY,
+    GL_UNSIGNED_INT_IMAGE_1D,
+    GL_UNSIGNED_INT_IMAGE_2D,
+    GL_UNSIGNED_INT_IMAGE_3D,
+    GL_UNSIGNED_INT_IMAGE_2D_RECT,
+    GL_UNSIGNED_INT_IMAGE_CUBE,
+    GL_UNSIGNED_INT_IMAGE_BUFFER,
+    GL_UNSIGNED_INT_IMAGE_1D_ARRAY,
+    GL_UNSIGNED_INT_IMAGE_2D_ARRAY,
+    GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY,
+    GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE,
+    GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY,
+});
+
+// samplers, images and bools are set through glUniform1i
+[[nodiscard]] static auto can_set_uniform_from(GLenum uniform_type, GLenum value_type) noexcept -> bool
+{
+    if (uniform_type == value_type)
+        return true;
+
+    if (value_type != GL_INT)
+        return false;
+
+    return uniform_type == GL_BOOL
+           || std::ranges::find(sampler_and_image_types, uniform_type) != sampler_and_image_types.end();
+}
+
+// size of a value as it's passed to glUniform*, 0 for types that aren't shadowed
+[[nodiscard]] static auto get_uniform_type_size(GLenum type) noexcept -> u32
+{
+    switch (type)
+    {
+    case GL_FLOAT:
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_BOOL:
+        return 4;
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC2:
+        return 8;
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC3:
+        return 12;
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_UNSIGNED_INT_VEC4:
+    case GL_FLOAT_MAT2:
+        return 16;
+    case GL_FLOAT_MAT3:
+        return 36;
+    case GL_FLOAT_MAT4:
+        return 64;
+    default:
+        return std::ranges::find(sampler_and_image_types, type) != sampler_and_image_types.end() ? 4 : 0;
+    }
+}
+
+template<typename T>
+static auto set_program_uniform_from_bytes(GLuint program, GLint location, std::span<const std::byte> bytes)
+    -> void
+{
+    std::vector<T> values(bytes.size() / sizeof(T));
+    std::memcpy(values.data(), bytes.data(), values.size() * sizeof(T));
+    set_program_uniform(program, location, std::span<const T>{ values });
+}
+
+// sets a uniform from its shadowed bytes; returns false for types set_program_uniform() doesn't cover
+[[nodiscard]] static auto restore_uniform(GLuint program, GLint location, GLenum type,
+                                          std::span<const std::byte> bytes) -> bool
 {
-    if (id == invalid_shader_id)
+    switch (type)
+    {
+    case GL_FLOAT:
+        set_program_uniform_from_bytes<GLfloat>(program, location, bytes);
+        return true;
+    case GL_FLOAT_VEC2:
+        set_program_uniform_from_bytes<glm::vec2>(program, location, bytes);
+        return true;
+    case GL_FLOAT_VEC3:
+        set_program_uniform_from_bytes<glm::vec3>(program, location, bytes);
+        return true;
+    case GL_FLOAT_VEC4:
+        set_program_uniform_from_bytes<glm::vec4>(program, location, bytes);
+        return true;
+    case GL_INT_VEC2:
+        set_program_uniform_from_bytes<glm::ivec2>(program, location, bytes);
+        return true;
+    case GL_INT_VEC3:
+        set_program_uniform_from_bytes<glm::ivec3>(program, location, bytes);
+        return true;
+    case GL_INT_VEC4:
+        set_program_uniform_from_bytes<glm::ivec4>(program, location, bytes);
+        return true;
+    case GL_UNSIGNED_INT:
+        set_program_uniform_from_bytes<GLuint>(program, location, bytes);
+        return true;
+    case GL_FLOAT_MAT3:
+        set_program_uniform_from_bytes<glm::mat3>(program, location, bytes);
+        return true;
+    case GL_FLOAT_MAT4:
+        set_program_uniform_from_bytes<glm::mat4>(program, location, bytes);
+        return true;
+    default:
+        // GL_INT, bools, samplers and images
+        if (!can_set_uniform_from(type, GL_INT))
+            return false;
+
+        set_program_uniform_from_bytes<GLint>(program, location, bytes);
+        return true;
+    }
+}
+
+// blocks are sorted by name
+template<typename Blocks>
+[[nodiscard]] static auto find_block(Blocks& blocks, std::string_view name) noexcept
+    -> decltype(blocks.data())
+{
+    auto block = std::ranges::lower_bound(blocks, name, std::ranges::less{}, &BufferBlockInfo::name);
+
+    if (block == blocks.end() || block->name != name)
+        return nullptr;
+
+    return &*block;
+}
+
+static auto delete_shader_if_valid(GLuint id) noexcept -> void
+{
+    if (id != invalid_shader_id)
         glDeleteShader(id);
 }
 
-static auto delete_shader_program_if_invalid(GLuint id) noexcept -> void
+static auto delete_shader_program_if_valid(GLuint id) noexcept -> void
 {
-    if (id == invalid_shader_program_id)
+    if (id != invalid_shader_program_id)
         glDeleteProgram(id);
 }
 
 std::unordered_map<GLenum, const char*> Shader::_shader_type_to_str = {
     { GL_VERTEX_SHADER, "vertex" },
     { GL_FRAGMENT_SHADER, "fragment" },
+    { GL_COMPUTE_SHADER, "compute" },
 };
 
-Shader::Shader(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path)
+Shader::Shader(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+               const ProgramBinaryCache* binary_cache)
     : _vertex_shader_src_file_path(vertex_src_path.string()),
       _fragment_shader_src_file_path(fragment_src_path.string())
 {
+    std::optional<MappedFile> vertex_src;
+    std::optional<MappedFile> fragment_src;
+
+    try
+    {
+        vertex_src.emplace(vertex_src_path);
+        fragment_src.emplace(fragment_src_path);
+    }
+    catch (FileIoError& e)
+    {
+        GLenum shader_type = vertex_src ? GL_FRAGMENT_SHADER : GL_VERTEX_SHADER;
+        auto message =
+            std::format("Can't read {} shader source file: {}", _shader_type_to_str[shader_type], e.what());
+        log_error("{}", message);
+        throw CreateShaderError{ message };
+    }
+
+    create_program({ .vertex = vertex_src->view(), .fragment = fragment_src->view() }, binary_cache);
+}
+
+Shader::Shader(const AssetArchive& archive, const ShaderPath& vertex_src_path,
+               const ShaderPath& fragment_src_path, const ProgramBinaryCache* binary_cache)
+    : _vertex_shader_src_file_path(vertex_src_path.string()),
+      _fragment_shader_src_file_path(fragment_src_path.string())
+{
+    auto vertex_src = archive.find(vertex_src_path);
+    auto fragment_src = archive.find(fragment_src_path);
+
+    if (!vertex_src || !fragment_src) [[unlikely]]
+    {
+        GLenum shader_type = vertex_src ? GL_FRAGMENT_SHADER : GL_VERTEX_SHADER;
+        auto message = std::format("Can't read {} shader source file: Invalid file path: {} (in archive {})",
+                                   _shader_type_to_str[shader_type],
+                                   vertex_src ? _fragment_shader_src_file_path : _vertex_shader_src_file_path,
+                                   archive.path().string());
+        log_error("{}", message);
+        throw CreateShaderError{ message };
+    }
+
+    auto as_string_view = [](std::span<const std::byte> bytes) {
+        return std::string_view{ reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+    };
+
+    create_program({ .vertex = as_string_view(*vertex_src), .fragment = as_string_view(*fragment_src) },
+                   binary_cache);
+}
+
+Shader::Shader(GLuint program, std::string_view vertex_name, std::string_view fragment_name)
+    : _id(program), _vertex_shader_src_file_path(vertex_name), _fragment_shader_src_file_path(fragment_name)
+{
+    reflect_uniforms();
+    reflect_blocks();
+    use();
+}
+
+Shader::Shader(const ShaderSources& sources, const ProgramBinaryCache* binary_cache)
+    : _vertex_shader_src_file_path(sources.vertex_name), _fragment_shader_src_file_path(sources.fragment_name)
+{
+    create_program(sources, binary_cache);
+}
+
+Shader::Shader(const EmbeddedShaderSource& vertex_src, const EmbeddedShaderSource& fragment_src,
+               const ProgramBinaryCache* binary_cache)
+    : Shader(ShaderSources{ .vertex = vertex_src.source,
+                            .fragment = fragment_src.source,
+                            .vertex_name = vertex_src.name,
+                            .fragment_name = fragment_src.name },
+             binary_cache)
+{
+}
+
+auto Shader::create_program(const ShaderSources& sources, const ProgramBinaryCache* binary_cache) -> void
+{
+    u64 binary_key = 0;
+
+    if (binary_cache && binary_cache->is_supported())
+    {
+        binary_key = binary_cache->make_key(sources);
+
+        if (auto program = binary_cache->load(binary_key))
+        {
+            _id = program;
+            reflect_uniforms();
+            reflect_blocks();
+            use();
+            return;
+        }
+    }
+
     GLuint vertex_shader = invalid_shader_id;
     GLuint fragment_shader = invalid_shader_id;
     GLuint shader_program = invalid_shader_program_id;
 
     try
     {
-        vertex_shader = compile_shader(GL_VERTEX_SHADER, vertex_src_path);
-        fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_src_path);
-        shader_program = link_shader(vertex_shader, fragment_shader);
+        vertex_shader = compile_shader(GL_VERTEX_SHADER, sources.vertex);
+        fragment_shader = compile_shader(GL_FRAGMENT_SHADER, sources.fragment);
+        shader_program = link_shader(vertex_shader, fragment_shader, binary_cache != nullptr);
     }
     catch (CreateShaderError&)
     {
-        delete_shader_if_invalid(vertex_shader);
-        delete_shader_if_invalid(fragment_shader);
-        delete_shader_program_if_invalid(shader_program);
+        delete_shader_if_valid(vertex_shader);
+        delete_shader_if_valid(fragment_shader);
+        delete_shader_program_if_valid(shader_program);
 
         log_error("Couldn't create shader from files: {}, {}", _vertex_shader_src_file_path,
                   _fragment_shader_src_file_path);
@@ -54,56 +345,465 @@ Shader::Shader(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src
     glDeleteShader(fragment_shader);
 #endif
 
+    if (binary_cache)
+        binary_cache->store(binary_key, shader_program);
+
     _id = shader_program;
+    reflect_uniforms();
+    reflect_blocks();
     use();
 }
 
+auto Shader::find_uniform(std::string_view name) const noexcept -> const UniformInfo*
+{
+    if (name.ends_with(array_suffix))
+        name.remove_suffix(array_suffix.size());
+
+    auto uniform = std::ranges::lower_bound(_uniforms, name, std::ranges::less{}, &UniformInfo::name);
+
+    if (uniform == _uniforms.end() || uniform->name != name)
+        return nullptr;
+
+    return &*uniform;
+}
+
 auto Shader::get_unif_location(std::string_view name) const noexcept -> GLint
 {
-    GLint location;
+    auto uniform = find_uniform(name);
 
-    if (auto search_res = _unif_cache.find(name); search_res != _unif_cache.end()) [[likely]]
+    if (!uniform) [[unlikely]]
     {
-        location = search_res->second;
+        log_warning("Warning: Uniform {} in shader {} ({}, {}) doesn't exist!", name, _id,
+                    _vertex_shader_src_file_path, _fragment_shader_src_file_path);
+        return -1;
     }
-    else [[unlikely]]
+
+    return uniform->location;
+}
+
+auto Shader::reflect_uniforms() -> void
+{
+    _uniforms.clear();
+    _uniform_shadows.clear();
+    _uniform_values.clear();
+
+    GLint uniform_count = 0;
+    GLint max_name_length = 0;
+    glGetProgramInterfaceiv(_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniform_count);
+    glGetProgramInterfaceiv(_id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &max_name_length);
+
+    constexpr std::array<GLenum, 4> properties = { GL_BLOCK_INDEX, GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE };
+    std::vector<GLchar> name(static_cast<usize>(max_name_length));
+
+    for (GLuint i = 0; i < static_cast<GLuint>(uniform_count); i++)
     {
-        location = glGetUniformLocation(_id, name.data());
+        std::array<GLint, properties.size()> values;
+        glGetProgramResourceiv(_id, GL_UNIFORM, i, properties.size(), properties.data(), values.size(),
+                               nullptr, values.data());
+
+        auto [block_index, location, type, array_size] = values;
+
+        // block members are set through their buffer, not glUniform
+        if (block_index != -1)
+            continue;
+
+        GLsizei name_length = 0;
+        glGetProgramResourceName(_id, GL_UNIFORM, i, max_name_length, &name_length, name.data());
+
+        auto uniform_name = std::string_view{ name.data(), static_cast<usize>(name_length) };
+
+        if (uniform_name.ends_with(array_suffix))
+            uniform_name.remove_suffix(array_suffix.size());
+
+        _uniforms.push_back({
+            .name = std::string{ uniform_name },
+            .location = location,
+            .type = static_cast<GLenum>(type),
+            .array_size = array_size,
+        });
+    }
+
+    std::ranges::sort(_uniforms, std::ranges::less{}, &UniformInfo::name);
 
-        if (location == -1) [[unlikely]]
-            log_warning("Warning: Uniform {} in shader {} ({}, {}) doesn't exist!", name, _id,
-                        _vertex_shader_src_file_path, _fragment_shader_src_file_path);
+    u32 values_size = 0;
 
-        _unif_cache[name] = location;
+    for (const auto& uniform : _uniforms)
+    {
+        auto size = get_uniform_type_size(uniform.type) * static_cast<u32>(uniform.array_size);
+        _uniform_shadows.push_back({ .offset = values_size, .size = size });
+        values_size += size;
     }
 
-    return location;
+    _uniform_values.resize(values_size);
 }
 
-auto Shader::compile_shader(GLenum shader_type, const ShaderPath& shader_src_path) -> GLuint
+auto Shader::replace_program(Shader& replacement) -> void
+{
+    // the new program starts out with its uniforms' initial values, give it the ones set on the old one
+    for (u32 i = 0; i < replacement._uniforms.size(); i++)
+    {
+        const auto& uniform = replacement._uniforms[i];
+        auto old_uniform = find_uniform(uniform.name);
+
+        if (!old_uniform || old_uniform->type != uniform.type)
+            continue;
+
+        const auto& old_shadow = _uniform_shadows[static_cast<usize>(old_uniform - _uniforms.data())];
+        auto size = std::min(old_shadow.known_size, replacement._uniform_shadows[i].size);
+        auto value = std::span{ _uniform_values }.subspan(old_shadow.offset, size);
+
+        if (!value.empty() && restore_uniform(replacement._id, uniform.location, uniform.type, value))
+            (void)replacement.update_uniform_shadow(i, value);
+    }
+
+    // block bindings may have been set from outside the shader as well
+    for (const auto& old_block : _uniform_blocks)
+    {
+        auto block = find_block(replacement._uniform_blocks, old_block.name);
+
+        if (block && block->binding != old_block.binding)
+        {
+            glUniformBlockBinding(replacement._id, block->index, old_block.binding);
+            block->binding = old_block.binding;
+        }
+    }
+
+    for (const auto& old_block : _storage_blocks)
+    {
+        auto block = find_block(replacement._storage_blocks, old_block.name);
+
+        if (block && block->binding != old_block.binding)
+        {
+            glShaderStorageBlockBinding(replacement._id, block->index, old_block.binding);
+            block->binding = old_block.binding;
+        }
+    }
+
+    std::swap(_id, replacement._id);
+    std::swap(_uniforms, replacement._uniforms);
+    std::swap(_uniform_blocks, replacement._uniform_blocks);
+    std::swap(_storage_blocks, replacement._storage_blocks);
+    std::swap(_uniform_shadows, replacement._uniform_shadows);
+    std::swap(_uniform_values, replacement._uniform_values);
+
+    // both shaders' uniform tables changed, handles looked up on either of them are stale now
+    _generation = _next_generation++;
+    replacement._generation = _next_generation++;
+}
+
+auto Shader::find_uniform_block(std::string_view name) const noexcept -> const BufferBlockInfo*
+{
+    return find_block(_uniform_blocks, name);
+}
+
+auto Shader::set_uniform_block_binding(std::string_view name, u32 binding) -> void
+{
+    auto block = find_block(_uniform_blocks, name);
+
+    if (!block) [[unlikely]]
+    {
+        log_warning("Warning: Uniform block {} in shader {} ({}, {}) doesn't exist!", name, _id,
+                    _vertex_shader_src_file_path, _fragment_shader_src_file_path);
+        return;
+    }
+
+    if (block->binding == binding)
+        return;
+
+    glUniformBlockBinding(_id, block->index, binding);
+    block->binding = binding;
+}
+
+auto Shader::find_storage_block(std::string_view name) const noexcept -> const BufferBlockInfo*
+{
+    return find_block(_storage_blocks, name);
+}
+
+auto Shader::set_storage_block_binding(std::string_view name, u32 binding) -> void
+{
+    auto block = find_block(_storage_blocks, name);
+
+    if (!block) [[unlikely]]
+    {
+        log_warning("Warning: Shader storage block {} in shader {} ({}, {}) doesn't exist!", name, _id,
+                    _vertex_shader_src_file_path, _fragment_shader_src_file_path);
+        return;
+    }
+
+    if (block->binding == binding)
+        return;
+
+    glShaderStorageBlockBinding(_id, block->index, binding);
+    block->binding = binding;
+}
+
+auto Shader::reflect_blocks() -> void
+{
+    _uniform_blocks = reflect_block_interface(GL_UNIFORM_BLOCK, GL_UNIFORM);
+    _storage_blocks = reflect_block_interface(GL_SHADER_STORAGE_BLOCK, GL_BUFFER_VARIABLE);
+}
+
+auto Shader::reflect_block_interface(GLenum block_interface, GLenum variable_interface) const
+    -> std::vector<BufferBlockInfo>
+{
+    std::vector<BufferBlockInfo> blocks;
+
+    GLint block_count = 0;
+    GLint max_name_length = 0;
+    glGetProgramInterfaceiv(_id, block_interface, GL_ACTIVE_RESOURCES, &block_count);
+    glGetProgramInterfaceiv(_id, block_interface, GL_MAX_NAME_LENGTH, &max_name_length);
+
+    constexpr std::array<GLenum, 3> properties = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE,
+                                                   GL_NUM_ACTIVE_VARIABLES };
+    constexpr GLenum active_variables_property = GL_ACTIVE_VARIABLES;
+    constexpr GLenum offset_property = GL_OFFSET;
+    constexpr GLenum array_stride_property = GL_TOP_LEVEL_ARRAY_STRIDE;
+    std::vector<GLchar> name(static_cast<usize>(max_name_length));
+
+    for (GLuint i = 0; i < static_cast<GLuint>(block_count); i++)
+    {
+        std::array<GLint, properties.size()> values;
+        glGetProgramResourceiv(_id, block_interface, i, properties.size(), properties.data(), values.size(),
+                               nullptr, values.data());
+
+        auto [binding, data_size, member_count] = values;
+
+        GLsizei name_length = 0;
+        glGetProgramResourceName(_id, block_interface, i, max_name_length, &name_length, name.data());
+
+        // indices into the variable interface
+        std::vector<GLint> members(static_cast<usize>(member_count));
+        glGetProgramResourceiv(_id, block_interface, i, 1, &active_variables_property, member_count, nullptr,
+                               members.data());
+
+        std::vector<GLint> member_offsets(members.size());
+
+        for (usize member = 0; member < members.size(); member++)
+        {
+            glGetProgramResourceiv(_id, variable_interface, static_cast<GLuint>(members[member]), 1,
+                                   &offset_property, 1, nullptr, &member_offsets[member]);
+        }
+
+        // only buffer variables have a top level array stride
+        GLint array_stride = 0;
+
+        if (variable_interface == GL_BUFFER_VARIABLE && !members.empty())
+        {
+            glGetProgramResourceiv(_id, variable_interface, static_cast<GLuint>(members[0]), 1,
+                                   &array_stride_property, 1, nullptr, &array_stride);
+        }
+
+        std::ranges::sort(member_offsets);
+
+        blocks.push_back({
+            .name = std::string{ name.data(), static_cast<usize>(name_length) },
+            .index = i,
+            .binding = static_cast<GLuint>(binding),
+            .data_size = data_size,
+            .member_offsets = std::move(member_offsets),
+            .top_level_array_stride = array_stride,
+        });
+    }
+
+    std::ranges::sort(blocks, std::ranges::less{}, &BufferBlockInfo::name);
+    return blocks;
+}
+
+auto Shader::is_block_compatible(const BufferBlockInfo* block, std::string_view name, usize size,
+                                 std::span<const usize> offsets, usize array_stride) const -> bool
+{
+    if (!block) [[unlikely]]
+    {
+        log_warning("Warning: Block {} in shader {} ({}, {}) doesn't exist!", name, _id,
+                    _vertex_shader_src_file_path, _fragment_shader_src_file_path);
+        return false;
+    }
+
+    // drivers may or may not round the block size up to its alignment, the C++ side always does
+    if (static_cast<usize>(block->data_size) > size) [[unlikely]]
+    {
+        log_warning("Warning: Block {} in shader {} ({}, {}) is {} bytes, the C++ type only {}!", name, _id,
+                    _vertex_shader_src_file_path, _fragment_shader_src_file_path, block->data_size, size);
+        return false;
+    }
+
+    auto same_offset = [](GLint gl_offset, usize offset) { return static_cast<usize>(gl_offset) == offset; };
+
+    if (!std::ranges::equal(block->member_offsets, offsets, same_offset)) [[unlikely]]
+    {
+        log_warning("Warning: Block {} in shader {} ({}, {}) doesn't match the C++ type ({} vs {} members)!",
+                    name, _id, _vertex_shader_src_file_path, _fragment_shader_src_file_path,
+                    block->member_offsets.size(), offsets.size());
+        return false;
+    }
+
+    auto block_array_stride = static_cast<usize>(block->top_level_array_stride);
+
+    if (array_stride != 0 && block_array_stride != array_stride) [[unlikely]]
+    {
+        log_warning("Warning: Block {} in shader {} ({}, {}) has an array stride of {}, the C++ type {}!",
+                    name, _id, _vertex_shader_src_file_path, _fragment_shader_src_file_path,
+                    block_array_stride, array_stride);
+        return false;
+    }
+
+    return true;
+}
+
+auto Shader::update_uniform_shadow(u32 index, std::span<const std::byte> value) const noexcept -> bool
+{
+    auto& shadow = _uniform_shadows[index];
+    auto shadowed_value = std::span{ _uniform_values }.subspan(shadow.offset, shadow.size);
+
+    // e.g. double uniforms aren't shadowed, there's nothing to compare against
+    if (value.size() > shadow.size) [[unlikely]]
+    {
+        _uniform_stats.issued_calls++;
+        return true;
+    }
+
+    if (value.size() <= shadow.known_size && std::ranges::equal(value, shadowed_value.first(value.size())))
+    {
+        _uniform_stats.skipped_calls++;
+        return false;
+    }
+
+    std::ranges::copy(value, shadowed_value.begin());
+    shadow.known_size = std::max(shadow.known_size, static_cast<u32>(value.size()));
+    _uniform_stats.issued_calls++;
+    return true;
+}
+
+auto Shader::warn_stale_uniform_handle([[maybe_unused]] u32 index) const noexcept -> void
+{
+#ifdef _DEBUG
+    if (_warned_stale_uniform_handle)
+        return;
+
+    _warned_stale_uniform_handle = true;
+    log_warning("Uniform handle {} used with another program than it was looked up on ({}, {}), ignoring it",
+                index, _vertex_shader_src_file_path, _fragment_shader_src_file_path);
+#endif
+}
+
+auto Shader::find_uniform_index(std::string_view name, GLenum value_type) const -> std::optional<u32>
+{
+    auto uniform = find_uniform(name);
+
+    if (!uniform) [[unlikely]]
+    {
+        log_warning("Warning: Uniform {} in shader {} ({}, {}) doesn't exist!", name, _id,
+                    _vertex_shader_src_file_path, _fragment_shader_src_file_path);
+        return std::nullopt;
+    }
+
+    if (!can_set_uniform_from(uniform->type, value_type)) [[unlikely]]
+    {
+        log_warning("Warning: Uniform {} in shader {} ({}, {}) has type {:#x}, can't set it from a {:#x}!",
+                    name, _id, _vertex_shader_src_file_path, _fragment_shader_src_file_path, uniform->type,
+                    value_type);
+        return std::nullopt;
+    }
+
+    return static_cast<u32>(uniform - _uniforms.data());
+}
+
+auto Shader::compile_shader(GLenum shader_type, std::string_view shader_src) -> GLuint
+{
+    GLuint shader = begin_compile_shader(shader_type, shader_src);
+
+    try
+    {
+        check_compile_status(shader_type, shader);
+    }
+    catch (CreateShaderError&)
+    {
+        glDeleteShader(shader);
+        throw;
+    }
+
+    return shader;
+}
+
+auto Shader::link_shader(GLuint vertex_shader, GLuint fragment_shader, bool binary_retrievable) -> GLuint
+{
+    GLuint shader_program = begin_link_shader(vertex_shader, fragment_shader, binary_retrievable);
+
+    try
+    {
+        check_link_status(shader_program);
+    }
+    catch (CreateShaderError&)
+    {
+        glDeleteProgram(shader_program);
+        throw;
+    }
+
+    return shader_program;
+}
+
+auto Shader::create_single_stage_program(GLenum shader_type, std::string_view shader_src,
+                                         std::string_view name, bool separable) -> GLuint
+{
+    GLuint shader = invalid_shader_id;
+    GLuint shader_program = invalid_shader_program_id;
+
+    try
+    {
+        shader = compile_shader(shader_type, shader_src);
+
+        shader_program = glCreateProgram();
+        glProgramParameteri(shader_program, GL_PROGRAM_SEPARABLE, separable ? GL_TRUE : GL_FALSE);
+        glAttachShader(shader_program, shader);
+        glLinkProgram(shader_program);
+
+        // only flagged for deletion while attached, it goes away with the program
+        glDeleteShader(shader);
+        shader = invalid_shader_id;
+
+        check_link_status(shader_program);
+    }
+    catch (CreateShaderError&)
+    {
+        delete_shader_if_valid(shader);
+        delete_shader_program_if_valid(shader_program);
+
+        log_error("Couldn't create {} shader from file: {}", _shader_type_to_str[shader_type], name);
+
+        throw;
+    }
+
+    return shader_program;
+}
+
+auto Shader::read_single_stage_source(const ShaderPath& src_path, std::string_view stage_name) -> MappedFile
 {
     try
     {
-        auto src = read_from_file(shader_src_path);
-        auto src_view = src.view();
-        return compile_shader(shader_type, src_view);
+        return MappedFile{ src_path };
     }
     catch (FileIoError& e)
     {
-        auto message =
-            std::format("Can't read {} shader source file: {}", _shader_type_to_str[shader_type], e.what());
+        auto message = std::format("Can't read {} source file: {}", stage_name, e.what());
         log_error("{}", message);
         throw CreateShaderError{ message };
     }
 }
 
-auto Shader::compile_shader(GLenum shader_type, std::string_view shader_src) -> GLuint
+auto Shader::begin_compile_shader(GLenum shader_type, std::string_view shader_src) noexcept -> GLuint
 {
+    // the length is passed explicitly, so the source doesn't have to be null-terminated
     auto src_ptr = shader_src.data();
+    auto src_length = static_cast<GLint>(shader_src.size());
     GLuint shader = glCreateShader(shader_type);
-    glShaderSource(shader, 1, &src_ptr, NULL);
+    glShaderSource(shader, 1, &src_ptr, &src_length);
     glCompileShader(shader);
 
+    return shader;
+}
+
+auto Shader::check_compile_status(GLenum shader_type, GLuint shader) -> void
+{
     GLint success = 0;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
 
@@ -119,17 +819,25 @@ auto Shader::compile_shader(GLenum shader_type, std::string_view shader_src) ->
         log_error("{}", message);
         throw CreateShaderError{ message };
     }
-
-    return shader;
 }
 
-auto Shader::link_shader(GLuint vertex_shader, GLuint fragment_shader) -> GLuint
+auto Shader::begin_link_shader(GLuint vertex_shader, GLuint fragment_shader, bool binary_retrievable) noexcept
+    -> GLuint
 {
     GLuint shader_program = glCreateProgram();
     glAttachShader(shader_program, vertex_shader);
     glAttachShader(shader_program, fragment_shader);
+
+    if (binary_retrievable)
+        glProgramParameteri(shader_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     glLinkProgram(shader_program);
 
+    return shader_program;
+}
+
+auto Shader::check_link_status(GLuint shader_program) -> void
+{
     GLint success = 0;
     glGetProgramiv(shader_program, GL_LINK_STATUS, &success);
 
@@ -144,6 +852,4 @@ auto Shader::link_shader(GLuint vertex_shader, GLuint fragment_shader) -> GLuint
         log_error("{}", message);
         throw CreateShaderError{ message };
     }
-
-    return shader_program;
 }
@@ -2,54 +2,225 @@
 
 #include <glad/glad.h>
 
+#include <atomic>
 #include <filesystem>
 
+#include "gl/embedded_shader_source.hpp"
+#include "gl/gl_state.hpp"
+#include "gl/std_layout.hpp"
+#include "gl/uniform.hpp"
+
+class AssetArchive;
+class MappedFile;
+class ProgramBinaryCache;
+
+// sources don't have to be null-terminated, names are only used for error messages
+struct ShaderSources
+{
+    std::string_view vertex;
+    std::string_view fragment;
+    std::string_view vertex_name = "<memory>";
+    std::string_view fragment_name = "<memory>";
+};
+
 class Shader
 {
 public:
     using ShaderPath = std::filesystem::path;
 
+    // with a binary cache, the program is loaded from it if possible and stored in it otherwise
+
     // throws CreateShaderError
-    explicit Shader(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path);
-    inline ~Shader() noexcept { glDeleteProgram(_id); };
+    explicit Shader(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+                    const ProgramBinaryCache* binary_cache = nullptr);
+    // throws CreateShaderError
+    explicit Shader(const AssetArchive& archive, const ShaderPath& vertex_src_path,
+                    const ShaderPath& fragment_src_path, const ProgramBinaryCache* binary_cache = nullptr);
+    // throws CreateShaderError
+    explicit Shader(const ShaderSources& sources, const ProgramBinaryCache* binary_cache = nullptr);
+    // sources compiled into the binary, e.g. embedded_shader(EmbeddedShaderId::basic_vert); no file is read
+    // throws CreateShaderError
+    explicit Shader(const EmbeddedShaderSource& vertex_src, const EmbeddedShaderSource& fragment_src,
+                    const ProgramBinaryCache* binary_cache = nullptr);
+    inline ~Shader() noexcept { gl_state().delete_program(_id); };
 
     Shader(const Shader& other) = delete;
     Shader(Shader&& other) = delete;
 
-    inline auto use() const noexcept -> void { glUseProgram(_id); }
+    inline auto use() const noexcept -> void { gl_state().use_program(_id); }
     [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
 
+    // uniforms outside of blocks, sorted by name
+    [[nodiscard]] inline auto uniforms() const noexcept -> std::span<const UniformInfo> { return _uniforms; }
+    // "name" and "name[0]" both find an array; nullptr if there's no such active uniform
+    [[nodiscard]] auto find_uniform(std::string_view name) const noexcept -> const UniformInfo*;
+    // returns -1 and logs a warning if there's no such active uniform
     [[nodiscard]] auto get_unif_location(std::string_view name) const noexcept -> GLint;
 
-    template<typename T> auto set_unif(std::string_view name, T val) const noexcept -> void
+    // returns an invalid handle and logs a warning if there's no such uniform or its type doesn't match T
+    template<typename T> [[nodiscard]] auto get_uniform(std::string_view name) const -> UniformHandle<T>
+    {
+        auto index = find_uniform_index(name, get_uniform_type<T>());
+
+        if (!index) [[unlikely]]
+            return {};
+
+        return { .index = *index, .location = _uniforms[*index].location, .program_generation = _generation };
+    }
+
+    // uniforms are set on this program directly, it doesn't have to be in use; values are shadowed on the
+    // CPU and setting a uniform to the value it already has doesn't reach GL
+    template<typename T> inline auto set_unif(UniformHandle<T> uniform, const T& value) const noexcept -> void
     {
-        static_assert(false, "not implemented");
+        set_unif(uniform, std::span<const T>{ &value, 1 });
     }
 
-    template<> inline auto set_unif<GLfloat>(std::string_view name, GLfloat val) const noexcept -> void
+    template<typename T>
+    inline auto set_unif(UniformHandle<T> uniform, std::span<const T> values) const noexcept -> void
     {
-        GLint location = get_unif_location(name);
-        glUniform1f(location, val);
+        if (uniform.program_generation != _generation) [[unlikely]]
+        {
+            if (uniform.is_valid())
+                warn_stale_uniform_handle(uniform.index);
+
+            return;
+        }
+
+        if (update_uniform_shadow(uniform.index, std::as_bytes(values)))
+            set_program_uniform(_id, uniform.location, values);
     }
 
-    template<> inline auto set_unif<GLint>(std::string_view name, GLint val) const noexcept -> void
+    // looks the uniform up on every call, hot paths should hold on to a handle instead
+    template<typename T> inline auto set_unif(std::string_view name, const T& value) const -> void
     {
-        GLint location = get_unif_location(name);
-        glUniform1i(location, val);
+        set_unif(get_uniform<T>(name), value);
     }
 
+    // uniform blocks, sorted by name; buffers are attached to them through binding points shared by all
+    // programs, see UniformBuffer
+    [[nodiscard]] inline auto uniform_blocks() const noexcept -> std::span<const BufferBlockInfo>
+    {
+        return _uniform_blocks;
+    }
+    // nullptr if there's no such active block
+    [[nodiscard]] auto find_uniform_block(std::string_view name) const noexcept -> const BufferBlockInfo*;
+    // logs a warning if there's no such active block; prefer layout(binding = n) in the shader if possible
+    auto set_uniform_block_binding(std::string_view name, u32 binding) -> void;
+
+    // logs a warning and returns false if there's no such block or it isn't laid out like T in std140
+    template<typename T> [[nodiscard]] auto is_uniform_block_compatible(std::string_view name) const -> bool
+    {
+        std::vector<usize> offsets;
+        collect_std_layout_member_offsets<StdLayout::std140, T>(offsets);
+
+        constexpr auto size = get_std_layout_info<StdLayout::std140, T>().size;
+        return is_block_compatible(find_uniform_block(name), name, size, offsets);
+    }
+
+    // shader storage blocks, sorted by name, see ShaderStorageBuffer
+    [[nodiscard]] inline auto storage_blocks() const noexcept -> std::span<const BufferBlockInfo>
+    {
+        return _storage_blocks;
+    }
+    // nullptr if there's no such active block
+    [[nodiscard]] auto find_storage_block(std::string_view name) const noexcept -> const BufferBlockInfo*;
+    // logs a warning if there's no such active block; prefer layout(binding = n) in the shader if possible
+    auto set_storage_block_binding(std::string_view name, u32 binding) -> void;
+
+    // logs a warning and returns false if there's no such block or it isn't an unsized array of T in std430,
+    // e.g. "layout(std430) buffer Instances { Instance instances[]; };"
+    template<typename T> [[nodiscard]] auto is_storage_block_compatible(std::string_view name) const -> bool
+    {
+        std::vector<usize> offsets;
+        collect_std_layout_member_offsets<StdLayout::std430, T>(offsets);
+
+        // the minimum size GL reports for a block ending in an unsized array counts one element
+        constexpr auto stride = get_std_layout_array_stride<StdLayout::std430, T>();
+        return is_block_compatible(find_storage_block(name), name, stride, offsets, stride);
+    }
+
+    // Takes over the replacement's program, e.g. a rebuilt version of this shader, and leaves it with the
+    // old one. Uniform values and block bindings set on the old program are carried over where the new one
+    // has a uniform or block of the same name and type. Uniform handles of either shader have to be looked
+    // up again, the old ones are ignored by set_unif.
+    auto replace_program(Shader& replacement) -> void;
+
+    [[nodiscard]] inline auto uniform_stats() const noexcept -> const UniformStats& { return _uniform_stats; }
+    inline auto reset_uniform_stats() const noexcept -> void { _uniform_stats = {}; }
+
+protected:
+    // takes ownership of an already linked program
+    explicit Shader(GLuint program, std::string_view vertex_name, std::string_view fragment_name);
+
+    // for programs with a single stage, e.g. compute or separable ones; the name is only used for messages
+    // throws CreateShaderError
+    [[nodiscard]] static auto create_single_stage_program(GLenum shader_type, std::string_view shader_src,
+                                                          std::string_view name, bool separable) -> GLuint;
+    // the source of such a program; stage_name is what the error message calls it, e.g. "compute shader"
+    // throws CreateShaderError
+    [[nodiscard]] static auto read_single_stage_source(const ShaderPath& src_path,
+                                                       std::string_view stage_name) -> MappedFile;
+
 private:
-    [[nodiscard]] static auto compile_shader(GLenum shader_type, const ShaderPath& shader_src_path) -> GLuint;
+    auto create_program(const ShaderSources& sources, const ProgramBinaryCache* binary_cache) -> void;
+    auto reflect_uniforms() -> void;
+    auto reflect_blocks() -> void;
+    [[nodiscard]] auto reflect_block_interface(GLenum block_interface, GLenum variable_interface) const
+        -> std::vector<BufferBlockInfo>;
+    // array_stride is only checked if it isn't 0
+    [[nodiscard]] auto is_block_compatible(const BufferBlockInfo* block, std::string_view name, usize size,
+                                           std::span<const usize> offsets, usize array_stride = 0) const
+        -> bool;
+    [[nodiscard]] auto find_uniform_index(std::string_view name, GLenum value_type) const
+        -> std::optional<u32>;
+    // returns true if the value differs from the shadowed one, which is then updated
+    [[nodiscard]] auto update_uniform_shadow(u32 index, std::span<const std::byte> value) const noexcept
+        -> bool;
+    // debug builds only, once per shader
+    auto warn_stale_uniform_handle(u32 index) const noexcept -> void;
+
     [[nodiscard]] static auto compile_shader(GLenum shader_type, std::string_view shader_src) -> GLuint;
-    [[nodiscard]] static auto link_shader(GLuint vertex_shader, GLuint fragment_shader) -> GLuint;
+    [[nodiscard]] static auto link_shader(GLuint vertex_shader, GLuint fragment_shader,
+                                          bool binary_retrievable = false) -> GLuint;
+
+    // compiling and linking split into issuing the work and waiting for its result, so the driver can
+    // work on many shaders at once; the checks throw CreateShaderError but leave deleting to the caller
+    [[nodiscard]] static auto begin_compile_shader(GLenum shader_type, std::string_view shader_src) noexcept
+        -> GLuint;
+    static auto check_compile_status(GLenum shader_type, GLuint shader) -> void;
+    [[nodiscard]] static auto begin_link_shader(GLuint vertex_shader, GLuint fragment_shader,
+                                                bool binary_retrievable) noexcept -> GLuint;
+    static auto check_link_status(GLuint shader_program) -> void;
 
 private:
+    // unique across all shaders and renewed by replace_program, so handles can tell which program they're for
+    static inline std::atomic<u32> _next_generation = 1;
+
     GLuint _id;
+    u32 _generation = _next_generation++;
     std::string _vertex_shader_src_file_path;
     std::string _fragment_shader_src_file_path;
-    mutable std::unordered_map<std::string_view, GLint> _unif_cache{};
+    std::vector<UniformInfo> _uniforms{};
+    std::vector<BufferBlockInfo> _uniform_blocks{};
+    std::vector<BufferBlockInfo> _storage_blocks{};
+
+    // last value set for each uniform, in _uniform_values[offset, offset + known_size); nothing is known
+    // right after linking, uniforms can have initializers
+    struct UniformShadow
+    {
+        u32 offset;
+        u32 size;
+        u32 known_size = 0;
+    };
+
+    mutable std::vector<UniformShadow> _uniform_shadows{};
+    mutable std::vector<std::byte> _uniform_values{};
+    mutable UniformStats _uniform_stats{};
+    mutable bool _warned_stale_uniform_handle = false;
 
     static std::unordered_map<GLenum, const char*> _shader_type_to_str;
+
+    friend class ShaderBatch;
 };
 
 class CreateShaderError : public std::runtime_error
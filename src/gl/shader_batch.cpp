@@ -0,0 +1,139 @@
+#include "shader_batch.hpp"
+
+#include "core/log.hpp"
+#include "gl/gl_extensions.hpp"
+#include "gl/program_binary_cache.hpp"
+
+// lets the driver pick how many compiler threads to use
+static constexpr GLuint driver_chosen_compiler_thread_count = 0xffffffff;
+
+ShaderBatch::ShaderBatch(const ProgramBinaryCache* binary_cache)
+    : _binary_cache(binary_cache), _parallel(gl_extensions().max_shader_compiler_threads != nullptr)
+{
+    if (_parallel)
+        gl_extensions().max_shader_compiler_threads(driver_chosen_compiler_thread_count);
+}
+
+ShaderBatch::~ShaderBatch() noexcept
+{
+    for (auto& [handle, build] : _builds)
+    {
+        if (build.result)
+            continue;
+
+        glDeleteShader(build.vertex_shader);
+        glDeleteShader(build.fragment_shader);
+        glDeleteProgram(build.program);
+    }
+}
+
+auto ShaderBatch::submit(const ShaderSources& sources) -> ShaderBuildHandle
+{
+    auto handle = _next_handle++;
+    auto& build = _builds[handle];
+    build.vertex_name = sources.vertex_name;
+    build.fragment_name = sources.fragment_name;
+
+    if (_binary_cache && _binary_cache->is_supported())
+    {
+        build.binary_key = _binary_cache->make_key(sources);
+
+        if (auto program = _binary_cache->load(build.binary_key))
+        {
+            // Shader's adopting constructor is private, hence no make_unique
+            auto shader = new Shader(program, build.vertex_name, build.fragment_name);
+            build.result = std::unique_ptr<Shader>(shader);
+            return handle;
+        }
+    }
+
+    build.vertex_shader = Shader::begin_compile_shader(GL_VERTEX_SHADER, sources.vertex);
+    build.fragment_shader = Shader::begin_compile_shader(GL_FRAGMENT_SHADER, sources.fragment);
+    build.program = Shader::begin_link_shader(build.vertex_shader, build.fragment_shader,
+                                              _binary_cache != nullptr);
+
+    _pending_count++;
+    return handle;
+}
+
+auto ShaderBatch::poll() -> usize
+{
+    usize finished = 0;
+
+    for (auto& [handle, build] : _builds)
+    {
+        if (!build.result && is_complete(build))
+        {
+            finish(build);
+            finished++;
+        }
+    }
+
+    return finished;
+}
+
+auto ShaderBatch::wait() -> void
+{
+    for (auto& [handle, build] : _builds)
+    {
+        if (!build.result)
+            finish(build);
+    }
+}
+
+auto ShaderBatch::is_finished(ShaderBuildHandle handle) const noexcept -> bool
+{
+    auto build = _builds.find(handle);
+    return build != _builds.end() && build->second.result.has_value();
+}
+
+auto ShaderBatch::take(ShaderBuildHandle handle) -> ShaderBuildResult
+{
+    auto node = _builds.extract(handle);
+    return std::move(*node.mapped().result);
+}
+
+auto ShaderBatch::is_complete(const Build& build) const noexcept -> bool
+{
+    // without the extension there's no way to ask, finishing will just block
+    if (!_parallel)
+        return true;
+
+    // a program only completes after its shaders did
+    GLint completed = GL_FALSE;
+    glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+auto ShaderBatch::finish(Build& build) -> void
+{
+    _pending_count--;
+
+    try
+    {
+        Shader::check_compile_status(GL_VERTEX_SHADER, build.vertex_shader);
+        Shader::check_compile_status(GL_FRAGMENT_SHADER, build.fragment_shader);
+        Shader::check_link_status(build.program);
+    }
+    catch (CreateShaderError& e)
+    {
+        glDeleteShader(build.vertex_shader);
+        glDeleteShader(build.fragment_shader);
+        glDeleteProgram(build.program);
+
+        log_error("Couldn't create shader from files: {}, {}", build.vertex_name, build.fragment_name);
+
+        build.result = std::unexpected{ e };
+        return;
+    }
+
+#ifndef _DEBUG
+    glDeleteShader(build.vertex_shader);
+    glDeleteShader(build.fragment_shader);
+#endif
+
+    if (_binary_cache)
+        _binary_cache->store(build.binary_key, build.program);
+
+    build.result = std::unique_ptr<Shader>(new Shader(build.program, build.vertex_name, build.fragment_name));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/shader.hpp"
+
+class ProgramBinaryCache;
+
+using ShaderBuildHandle = u32;
+using ShaderBuildResult = std::expected<std::unique_ptr<Shader>, CreateShaderError>;
+
+// Builds many shaders without waiting on each one. submit() only issues the compile and link calls;
+// querying their status is what makes the driver finish the work, so it's put off until poll() or wait().
+//
+// With KHR_parallel_shader_compile the driver compiles on its own threads, and poll() only collects
+// programs whose GL_COMPLETION_STATUS_KHR says they're done. Without it poll() has to block, but every
+// submitted compile has been issued before the first status query.
+//
+// Needs a current context; all calls have to happen on its thread.
+class ShaderBatch
+{
+public:
+    explicit ShaderBatch(const ProgramBinaryCache* binary_cache = nullptr);
+    ~ShaderBatch() noexcept;
+
+    ShaderBatch(const ShaderBatch& other) = delete;
+    ShaderBatch(ShaderBatch&& other) = delete;
+
+    // the sources are copied by the driver, they don't have to outlive the call
+    [[nodiscard]] auto submit(const ShaderSources& sources) -> ShaderBuildHandle;
+
+    // finishes the builds that are done without blocking if the driver allows it; returns how many finished
+    auto poll() -> usize;
+    // finishes every build
+    auto wait() -> void;
+
+    [[nodiscard]] auto is_finished(ShaderBuildHandle handle) const noexcept -> bool;
+    // the build has to be finished; its result can only be taken once
+    [[nodiscard]] auto take(ShaderBuildHandle handle) -> ShaderBuildResult;
+
+    [[nodiscard]] inline auto pending_count() const noexcept -> usize { return _pending_count; }
+    [[nodiscard]] inline auto is_parallel() const noexcept -> bool { return _parallel; }
+
+private:
+    struct Build
+    {
+        std::string vertex_name;
+        std::string fragment_name;
+        GLuint vertex_shader = 0;
+        GLuint fragment_shader = 0;
+        GLuint program = 0;
+        u64 binary_key = 0;
+        std::optional<ShaderBuildResult> result{};
+    };
+
+    [[nodiscard]] auto is_complete(const Build& build) const noexcept -> bool;
+    auto finish(Build& build) -> void;
+
+private:
+    const ProgramBinaryCache* _binary_cache;
+    bool _parallel;
+    ShaderBuildHandle _next_handle = 0;
+    usize _pending_count = 0;
+    std::unordered_map<ShaderBuildHandle, Build> _builds{};
+};
@@ -0,0 +1,172 @@
+#include "shader_hot_reloader.hpp"
+
+#include "core/log.hpp"
+
+ShaderHotReloader::ShaderHotReloader(const ShaderPreprocessor* preprocessor)
+    : _preprocessor(preprocessor ? preprocessor : &_default_preprocessor)
+{
+}
+
+auto ShaderHotReloader::watch(Shader& shader, const ShaderPath& vertex_src_path,
+                              const ShaderPath& fragment_src_path, std::span<const ShaderDefine> defines,
+                              ShaderReloadCallback on_reload) -> void
+{
+    unwatch(shader);
+
+    auto& watched = _shaders.emplace_back(WatchedShader{ .shader = &shader,
+                                                         .vertex_src_path = vertex_src_path,
+                                                         .fragment_src_path = fragment_src_path,
+                                                         .defines = {},
+                                                         .on_reload = std::move(on_reload) });
+
+    for (const auto& define : defines)
+        watched.defines.emplace_back(define.name, define.value);
+
+    // reading the sources once finds the included files to watch; if that fails, the shader still gets
+    // rebuilt once its own files change
+    for (const auto& path : { &vertex_src_path, &fragment_src_path })
+        (void)read_source(watched, *path);
+}
+
+auto ShaderHotReloader::unwatch(const Shader& shader) noexcept -> void
+{
+    auto watched = std::ranges::find(_shaders, &shader, &WatchedShader::shader);
+
+    if (watched == _shaders.end())
+        return;
+
+    if (watched->build)
+        _abandoned_builds.push_back(*watched->build);
+
+    _shaders.erase(watched);
+}
+
+auto ShaderHotReloader::update(std::chrono::microseconds budget) -> usize
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    for (const auto& file : _watcher.poll())
+    {
+        for (auto& watched : _shaders)
+        {
+            if (std::ranges::find(watched.files, file) != watched.files.end())
+                watched.changed = true;
+        }
+    }
+
+    if (_batch.pending_count() > 0)
+        _batch.poll();
+
+    std::erase_if(_abandoned_builds, [&](ShaderBuildHandle build) {
+        if (!_batch.is_finished(build))
+            return false;
+
+        [[maybe_unused]] auto result = _batch.take(build);
+        return true;
+    });
+
+    usize swapped_count = 0;
+
+    for (auto& watched : _shaders)
+    {
+        if (watched.build && _batch.is_finished(*watched.build) && finish_rebuild(watched))
+            swapped_count++;
+    }
+
+    for (auto& watched : _shaders)
+    {
+        // one rebuild per shader at a time, a change during a rebuild starts another one after it
+        if (!watched.changed || watched.build)
+            continue;
+
+        if (std::chrono::steady_clock::now() - start_time >= budget)
+            break;
+
+        watched.changed = false;
+        (void)start_rebuild(watched);
+    }
+
+    return swapped_count;
+}
+
+auto ShaderHotReloader::start_rebuild(WatchedShader& watched) -> bool
+{
+    // the includes may have changed as well
+    watched.files.clear();
+
+    auto vertex_source = read_source(watched, watched.vertex_src_path);
+    auto fragment_source = read_source(watched, watched.fragment_src_path);
+
+    if (!vertex_source || !fragment_source) [[unlikely]]
+        return false;
+
+    auto vertex_name = watched.vertex_src_path.string();
+    auto fragment_name = watched.fragment_src_path.string();
+
+    watched.build = _batch.submit({ .vertex = *vertex_source,
+                                    .fragment = *fragment_source,
+                                    .vertex_name = vertex_name,
+                                    .fragment_name = fragment_name });
+    return true;
+}
+
+auto ShaderHotReloader::read_source(WatchedShader& watched, const ShaderPath& path)
+    -> std::optional<std::string>
+{
+    auto add_file = [&](const ShaderPath& file) {
+        auto absolute_file = std::filesystem::absolute(file).lexically_normal();
+
+        if (std::ranges::find(watched.files, absolute_file) != watched.files.end())
+            return;
+
+        _watcher.watch(absolute_file);
+        watched.files.push_back(std::move(absolute_file));
+    };
+
+    add_file(path);
+
+    std::vector<ShaderDefine> defines;
+    defines.reserve(watched.defines.size());
+
+    for (const auto& [name, value] : watched.defines)
+        defines.push_back({ .name = name, .value = value });
+
+    try
+    {
+        auto preprocessed = _preprocessor->process(path, defines);
+
+        for (const auto& file : preprocessed.files)
+            add_file(file);
+
+        return std::move(preprocessed.source);
+    }
+    catch (ShaderPreprocessError& e)
+    {
+        log_warning("Warning: Can't reload shader source {}: {}", path.string(), e.what());
+        return std::nullopt;
+    }
+}
+
+auto ShaderHotReloader::finish_rebuild(WatchedShader& watched) -> bool
+{
+    auto result = _batch.take(*watched.build);
+    watched.build.reset();
+
+    if (!result) [[unlikely]]
+    {
+        log_warning("Warning: Reloading shader {}, {} failed, the previous program stays in use: {}",
+                    watched.vertex_src_path.string(), watched.fragment_src_path.string(),
+                    result.error().what());
+        return false;
+    }
+
+    // the rebuilt shader is left with the old program, which is deleted along with it
+    watched.shader->replace_program(**result);
+
+    if (watched.on_reload)
+        watched.on_reload(*watched.shader);
+
+    log_notification("Reloaded shader {}, {}", watched.vertex_src_path.string(),
+                     watched.fragment_src_path.string());
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <filesystem>
+
+#include "gl/shader.hpp"
+#include "gl/shader_batch.hpp"
+#include "gl/shader_preprocessor.hpp"
+#include "io/file_watcher.hpp"
+
+using ShaderReloadCallback = std::function<void(Shader& shader)>;
+
+// Rebuilds shaders whose source files change on disk and swaps the new program in, for a short edit-measure
+// loop while working on shaders.
+//
+// Rebuilds go through a ShaderBatch on the context's thread. With KHR_parallel_shader_compile the driver
+// compiles in the background and update() never waits for it, otherwise a finished rebuild blocks for its
+// compile. The program is only swapped once the rebuild succeeded, in between draws; a rebuild that fails
+// is logged and the shader keeps running its current program.
+//
+// Needs a current context; all calls have to happen on its thread.
+class ShaderHotReloader
+{
+public:
+    using ShaderPath = std::filesystem::path;
+
+    // Sources always go through a preprocessor, without one given a default one without include directories
+    // is used; included files are watched as well.
+    explicit ShaderHotReloader(const ShaderPreprocessor* preprocessor = nullptr);
+
+    ShaderHotReloader(const ShaderHotReloader& other) = delete;
+    ShaderHotReloader(ShaderHotReloader&& other) = delete;
+
+    // The shader has to stay alive until it's unwatched. on_reload runs after every swap, e.g. to look
+    // uniform handles up again; uniform values and block bindings are carried over by Shader itself.
+    auto watch(Shader& shader, const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+               std::span<const ShaderDefine> defines = {}, ShaderReloadCallback on_reload = {}) -> void;
+    auto unwatch(const Shader& shader) noexcept -> void;
+
+    // swaps in finished rebuilds, then starts rebuilding shaders whose files changed until the budget is used
+    // up; returns how many shaders were swapped
+    auto update(std::chrono::microseconds budget) -> usize;
+
+    [[nodiscard]] inline auto watched_count() const noexcept -> usize { return _shaders.size(); }
+
+private:
+    struct WatchedShader
+    {
+        Shader* shader;
+        ShaderPath vertex_src_path;
+        ShaderPath fragment_src_path;
+        std::vector<std::pair<std::string, std::string>> defines;
+        ShaderReloadCallback on_reload;
+        std::vector<ShaderPath> files{}; // absolute, including the included ones
+        bool changed = false;
+        std::optional<ShaderBuildHandle> build{};
+    };
+
+    // returns false if the sources can't be read, the shader is then rebuilt on the next change
+    [[nodiscard]] auto start_rebuild(WatchedShader& watched) -> bool;
+    // adds the files the source was made from to watched.files and the watcher
+    [[nodiscard]] auto read_source(WatchedShader& watched, const ShaderPath& path)
+        -> std::optional<std::string>;
+    // returns true if the program was swapped
+    auto finish_rebuild(WatchedShader& watched) -> bool;
+
+private:
+    ShaderPreprocessor _default_preprocessor{};
+    const ShaderPreprocessor* _preprocessor;
+    FileWatcher _watcher{};
+    ShaderBatch _batch{};
+    std::vector<WatchedShader> _shaders{};
+    // builds of shaders unwatched while rebuilding, their results are thrown away
+    std::vector<ShaderBuildHandle> _abandoned_builds{};
+};
@@ -0,0 +1,214 @@
+#include "shader_preprocessor.hpp"
+
+#include "core/log.hpp"
+#include "io/mapped_file.hpp"
+
+static constexpr std::string_view whitespace = " \t\r";
+
+[[nodiscard]] static inline auto trim_front(std::string_view text) noexcept -> std::string_view
+{
+    auto start = text.find_first_not_of(whitespace);
+    return start == std::string_view::npos ? std::string_view{} : text.substr(start);
+}
+
+// for "#  name rest", returns "rest" if the line is a name directive
+[[nodiscard]] static auto match_directive(std::string_view line, std::string_view name) noexcept
+    -> std::optional<std::string_view>
+{
+    line = trim_front(line);
+
+    if (!line.starts_with('#'))
+        return std::nullopt;
+
+    line = trim_front(line.substr(1));
+
+    if (!line.starts_with(name))
+        return std::nullopt;
+
+    auto rest = line.substr(name.size());
+
+    // e.g. "#included" isn't an include
+    if (!rest.empty() && whitespace.find(rest.front()) == std::string_view::npos && rest.front() != '"'
+        && rest.front() != '<')
+        return std::nullopt;
+
+    return trim_front(rest);
+}
+
+// calls func with each line and its 1-based number, without the '\n'
+template<typename Func> static auto for_each_line(std::string_view source, Func&& func) -> void
+{
+    u32 line_number = 1;
+
+    while (!source.empty())
+    {
+        auto end = source.find('\n');
+        auto line = source.substr(0, end);
+        func(line, line_number++);
+
+        if (end == std::string_view::npos)
+            break;
+
+        source.remove_prefix(end + 1);
+    }
+}
+
+static auto append_defines(std::span<const ShaderDefine> defines, std::string& output) -> void
+{
+    for (const auto& define : defines)
+        output += std::format("#define {} {}\n", define.name, define.value);
+}
+
+ShaderPreprocessor::ShaderPreprocessor(std::vector<std::filesystem::path> include_directories)
+    : _include_directories(std::move(include_directories))
+{
+}
+
+auto ShaderPreprocessor::process(const std::filesystem::path& path,
+                                 std::span<const ShaderDefine> defines) const -> PreprocessedShader
+{
+    std::optional<MappedFile> file;
+
+    try
+    {
+        file.emplace(path);
+    }
+    catch (FileIoError& e)
+    {
+        auto message = std::format("Can't read shader source file: {}", e.what());
+        log_error("{}", message);
+        throw ShaderPreprocessError{ message };
+    }
+
+    return process(file->view(), path.string(), defines, path.parent_path());
+}
+
+auto ShaderPreprocessor::process(std::string_view source, std::string_view name,
+                                 std::span<const ShaderDefine> defines,
+                                 const std::filesystem::path& source_directory) const -> PreprocessedShader
+{
+    PreprocessedShader output;
+    output.source.reserve(source.size());
+    output.files.emplace_back(name);
+
+    std::set<std::filesystem::path> included;
+    append_source(source, 0, source_directory, defines, included, output);
+
+    return output;
+}
+
+auto ShaderPreprocessor::append_source(std::string_view source, u32 source_index,
+                                       const std::filesystem::path& directory,
+                                       std::span<const ShaderDefine> defines,
+                                       std::set<std::filesystem::path>& included,
+                                       PreprocessedShader& output) const -> void
+{
+    // without a #version the defines go first, otherwise right after it
+    bool has_version = false;
+
+    if (!defines.empty())
+    {
+        for_each_line(source, [&](std::string_view line, u32) {
+            has_version = has_version || match_directive(line, "version").has_value();
+        });
+    }
+
+    auto fail = [&](u32 line_number, std::string_view error) {
+        auto message = std::format("{}({}): {}", output.files[source_index].string(), line_number, error);
+        log_error("{}", message);
+        throw ShaderPreprocessError{ message };
+    };
+
+    if (!has_version && !defines.empty())
+    {
+        append_defines(defines, output.source);
+        output.source += std::format("#line 1 {}\n", source_index);
+    }
+
+    for_each_line(source, [&](std::string_view line, u32 line_number) {
+        if (has_version && match_directive(line, "version"))
+        {
+            output.source += line;
+            output.source += '\n';
+            append_defines(defines, output.source);
+            output.source += std::format("#line {} {}\n", line_number + 1, source_index);
+            return;
+        }
+
+        auto include = match_directive(line, "include");
+
+        if (!include)
+        {
+            output.source += line;
+            output.source += '\n';
+            return;
+        }
+
+        auto quoted = include->starts_with('"');
+        auto terminator = include->find(quoted ? '"' : '>', 1);
+
+        if ((!quoted && !include->starts_with('<')) || terminator == std::string_view::npos) [[unlikely]]
+            fail(line_number, "malformed #include");
+
+        auto include_name = include->substr(1, terminator - 1);
+        auto path = resolve_include(include_name, quoted, directory);
+
+        if (!path) [[unlikely]]
+            fail(line_number, std::format("can't find include file {}", include_name));
+
+        // keeps the line numbers of everything after it right
+        output.source += '\n';
+
+        if (!included.insert(*path).second)
+            return;
+
+        std::optional<MappedFile> file;
+
+        try
+        {
+            file.emplace(*path);
+        }
+        catch (FileIoError& e)
+        {
+            fail(line_number, std::format("can't read include file: {}", e.what()));
+        }
+
+        auto include_index = static_cast<u32>(output.files.size());
+        output.files.push_back(*path);
+
+        output.source += std::format("#line 1 {}\n", include_index);
+        append_source(file->view(), include_index, path->parent_path(), {}, included, output);
+        output.source += std::format("#line {} {}\n", line_number + 1, source_index);
+    });
+}
+
+auto ShaderPreprocessor::resolve_include(std::string_view name, bool quoted,
+                                         const std::filesystem::path& directory) const
+    -> std::optional<std::filesystem::path>
+{
+    auto try_directory = [&](const std::filesystem::path& search_directory) {
+        auto candidate = search_directory / name;
+        std::error_code error;
+
+        if (!std::filesystem::is_regular_file(candidate, error))
+            return std::optional<std::filesystem::path>{};
+
+        // canonical, so the same file reached through different relative paths is only included once
+        auto canonical = std::filesystem::weakly_canonical(candidate, error);
+        return std::optional{ error ? candidate.lexically_normal() : canonical };
+    };
+
+    if (quoted)
+    {
+        if (auto path = try_directory(directory))
+            return path;
+    }
+
+    for (const auto& include_directory : _include_directories)
+    {
+        if (auto path = try_directory(include_directory))
+            return path;
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <filesystem>
+
+struct ShaderDefine
+{
+    std::string_view name;
+    std::string_view value = {}; // empty for a plain "#define name"
+};
+
+struct PreprocessedShader
+{
+    std::string source;
+    // the source string numbers in the generated #line directives, and so in compiler messages, index this
+    std::vector<std::filesystem::path> files;
+};
+
+// Resolves #include directives and injects #defines, everything else is left to the GL compiler.
+//
+// Defines go right after #version, which has to stay the first directive, or at the start if there is none.
+// #include "file" is looked up next to the including file first, then in the include directories;
+// #include <file> only in the include directories. A file is included at most once per shader, which
+// works as an include guard and rules out cycles. #line directives keep compiler messages pointing at the
+// right file and line. Includes are resolved even inside #if blocks, which aren't evaluated here.
+class ShaderPreprocessor
+{
+public:
+    explicit ShaderPreprocessor(std::vector<std::filesystem::path> include_directories = {});
+
+    // throws ShaderPreprocessError
+    [[nodiscard]] auto process(const std::filesystem::path& path,
+                               std::span<const ShaderDefine> defines = {}) const -> PreprocessedShader;
+    // name is only used for error messages, relative includes are looked up in source_directory
+    // throws ShaderPreprocessError
+    [[nodiscard]] auto process(std::string_view source, std::string_view name,
+                               std::span<const ShaderDefine> defines = {},
+                               const std::filesystem::path& source_directory = {}) const
+        -> PreprocessedShader;
+
+    [[nodiscard]] inline auto include_directories() const noexcept -> std::span<const std::filesystem::path>
+    {
+        return _include_directories;
+    }
+
+private:
+    // appends source with its includes resolved, source_index is its index in output.files
+    auto append_source(std::string_view source, u32 source_index, const std::filesystem::path& directory,
+                       std::span<const ShaderDefine> defines, std::set<std::filesystem::path>& included,
+                       PreprocessedShader& output) const -> void;
+    [[nodiscard]] auto resolve_include(std::string_view name, bool quoted,
+                                       const std::filesystem::path& directory) const
+        -> std::optional<std::filesystem::path>;
+
+private:
+    std::vector<std::filesystem::path> _include_directories;
+};
+
+class ShaderPreprocessError : public std::runtime_error
+{
+public:
+    inline ShaderPreprocessError(const char* message) noexcept : std::runtime_error(message) {}
+    inline ShaderPreprocessError(const std::string& message) noexcept : std::runtime_error(message) {}
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/gl_state.hpp"
+#include "gl/std_layout.hpp"
+
+// A fixed-capacity array of T in a shader storage block, for per-instance data that's too big for uniforms,
+// e.g. transforms indexed with gl_InstanceID or vertices pulled with gl_VertexID:
+//
+//     struct Instance { glm::mat4 model; glm::vec4 color; };
+//     layout(std430, binding = 1) readonly buffer Instances { Instance instances[]; };
+//
+// Elements are written to a CPU copy in std430 layout, T itself needs no padding. flush() uploads the range
+// of elements written since the last flush with a single glBufferSubData, so changing a few instances of a
+// big scene only uploads those. Shader::is_storage_block_compatible<T>() checks a block against T.
+template<StdLayoutType T> class ShaderStorageBuffer
+{
+public:
+    static constexpr usize stride = get_std_layout_array_stride<StdLayout::std430, T>();
+
+    explicit inline ShaderStorageBuffer(usize capacity) noexcept
+        : _capacity(capacity), _staging(capacity * stride)
+    {
+        glGenBuffers(1, &_id);
+        gl_state().bind_buffer(GL_SHADER_STORAGE_BUFFER, _id);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(_staging.size()), nullptr,
+                     GL_DYNAMIC_DRAW);
+    }
+
+    inline ~ShaderStorageBuffer() noexcept { gl_state().delete_buffer(_id); }
+
+    ShaderStorageBuffer(const ShaderStorageBuffer& other) = delete;
+    ShaderStorageBuffer(ShaderStorageBuffer&& other) = delete;
+
+    // index has to be < capacity()
+    inline auto set(usize index, const T& value) noexcept -> void
+    {
+        write_std_layout<StdLayout::std430>(value, std::span{ _staging }.subspan(index * stride, stride));
+        mark_dirty(index, 1);
+    }
+
+    // first + values.size() has to be <= capacity()
+    inline auto set(usize first, std::span<const T> values) noexcept -> void
+    {
+        for (usize i = 0; i < values.size(); i++)
+        {
+            auto element = std::span{ _staging }.subspan((first + i) * stride, stride);
+            write_std_layout<StdLayout::std430>(values[i], element);
+        }
+
+        mark_dirty(first, values.size());
+    }
+
+    // uploads everything set since the last flush; the dirty elements are tracked as one range spanning all
+    // of them, so scattered updates upload the unchanged elements in between as well
+    inline auto flush() noexcept -> void
+    {
+        if (!is_dirty())
+            return;
+
+        auto offset = _dirty_first * stride;
+        auto size = (_dirty_end - _dirty_first) * stride;
+
+        gl_state().bind_buffer(GL_SHADER_STORAGE_BUFFER, _id);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(offset),
+                        static_cast<GLsizeiptr>(size), _staging.data() + offset);
+
+        _dirty_first = 0;
+        _dirty_end = 0;
+    }
+
+    inline auto bind(u32 binding) const noexcept -> void
+    {
+        gl_state().bind_buffer_base(GL_SHADER_STORAGE_BUFFER, binding, _id);
+    }
+
+    [[nodiscard]] inline auto capacity() const noexcept -> usize { return _capacity; }
+    [[nodiscard]] inline auto is_dirty() const noexcept -> bool { return _dirty_end != _dirty_first; }
+    [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
+
+private:
+    inline auto mark_dirty(usize first, usize count) noexcept -> void
+    {
+        if (count == 0)
+            return;
+
+        if (!is_dirty())
+        {
+            _dirty_first = first;
+            _dirty_end = first + count;
+            return;
+        }
+
+        _dirty_first = std::min(_dirty_first, first);
+        _dirty_end = std::max(_dirty_end, first + count);
+    }
+
+private:
+    GLuint _id;
+    usize _capacity;
+    std::vector<std::byte> _staging;
+
+    // elements [_dirty_first, _dirty_end) haven't been uploaded yet
+    usize _dirty_first = 0;
+    usize _dirty_end = 0;
+};
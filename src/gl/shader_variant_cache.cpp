@@ -0,0 +1,188 @@
+#include "shader_variant_cache.hpp"
+
+#include "core/hash.hpp"
+#include "core/log.hpp"
+
+ShaderVariantCache::ShaderVariantCache(const ShaderPreprocessor& preprocessor,
+                                       const ProgramBinaryCache* binary_cache)
+    : _preprocessor(preprocessor), _binary_cache(binary_cache)
+{
+}
+
+auto ShaderVariantCache::get(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+                             std::span<const ShaderDefine> defines) -> Shader&
+{
+    auto hash = make_key(vertex_src_path, fragment_src_path, defines);
+
+    auto variant = find_variant(_variants, hash, GL_NONE, vertex_src_path, fragment_src_path, defines);
+
+    if (variant) [[likely]]
+        return *variant;
+
+    auto shader = create_variant(vertex_src_path, fragment_src_path, defines);
+    auto key = make_variant_key(GL_NONE, vertex_src_path, fragment_src_path, defines);
+
+    return *_variants.emplace(hash, std::pair{ std::move(key), std::move(shader) })->second.second;
+}
+
+auto ShaderVariantCache::get_stage(GLenum shader_type, const ShaderPath& src_path,
+                                   std::span<const ShaderDefine> defines) -> ShaderStage&
+{
+    if (shader_type != GL_VERTEX_SHADER && shader_type != GL_FRAGMENT_SHADER) [[unlikely]]
+    {
+        auto message = std::format("Can't create shader stage from file: {}: type {:#x} isn't a vertex or "
+                                   "fragment shader",
+                                   src_path.string(), shader_type);
+        log_error("{}", message);
+        throw CreateShaderError{ message };
+    }
+
+    auto hash = hash_variant(shader_type, src_path, {}, defines);
+
+    if (auto stage = find_variant(_stages, hash, shader_type, src_path, {}, defines)) [[likely]]
+        return *stage;
+
+    PreprocessedShader preprocessed;
+
+    try
+    {
+        preprocessed = _preprocessor.process(src_path, defines);
+    }
+    catch (ShaderPreprocessError& e)
+    {
+        throw CreateShaderError{ e.what() };
+    }
+
+    std::unique_ptr<ShaderStage> stage;
+
+    try
+    {
+        stage = std::make_unique<ShaderStage>(shader_type, preprocessed.source, src_path.string());
+    }
+    catch (CreateShaderError&)
+    {
+        for (usize i = 0; i < preprocessed.files.size(); i++)
+            log_error("shader source string {}: {}", i, preprocessed.files[i].string());
+
+        throw;
+    }
+
+    auto key = make_variant_key(shader_type, src_path, {}, defines);
+    return *_stages.emplace(hash, std::pair{ std::move(key), std::move(stage) })->second.second;
+}
+
+auto ShaderVariantCache::make_key(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+                                  std::span<const ShaderDefine> defines) -> u64
+{
+    return hash_variant(GL_NONE, vertex_src_path, fragment_src_path, defines);
+}
+
+auto ShaderVariantCache::VariantKey::matches(GLenum type, const ShaderPath& first, const ShaderPath& second,
+                                             std::span<const ShaderDefine> other_defines) const noexcept
+    -> bool
+{
+    if (shader_type != type || first_src_path.native() != first.native()
+        || second_src_path.native() != second.native() || defines.size() != other_defines.size() * 2)
+        return false;
+
+    for (usize i = 0; i < other_defines.size(); i++)
+    {
+        if (defines[i * 2] != other_defines[i].name || defines[i * 2 + 1] != other_defines[i].value)
+            return false;
+    }
+
+    return true;
+}
+
+auto ShaderVariantCache::hash_variant(GLenum shader_type, const ShaderPath& first_src_path,
+                                      const ShaderPath& second_src_path,
+                                      std::span<const ShaderDefine> defines) -> u64
+{
+    // separators keep e.g. "AB" "C" and "A" "BC" apart
+    constexpr std::string_view separator{ "\0", 1 };
+
+    u64 hash = fnv1a_64(std::as_bytes(std::span{ &shader_type, 1 }));
+
+    for (const auto& path : { &first_src_path, &second_src_path })
+    {
+        hash = fnv1a_64(path->string(), hash);
+        hash = fnv1a_64(separator, hash);
+    }
+
+    for (const auto& define : defines)
+    {
+        hash = fnv1a_64(define.name, hash);
+        hash = fnv1a_64(separator, hash);
+        hash = fnv1a_64(define.value, hash);
+        hash = fnv1a_64(separator, hash);
+    }
+
+    return hash;
+}
+
+auto ShaderVariantCache::make_variant_key(GLenum shader_type, const ShaderPath& first_src_path,
+                                          const ShaderPath& second_src_path,
+                                          std::span<const ShaderDefine> defines) -> VariantKey
+{
+    VariantKey key{
+        .shader_type = shader_type,
+        .first_src_path = first_src_path,
+        .second_src_path = second_src_path,
+        .defines = {},
+    };
+
+    key.defines.reserve(defines.size() * 2);
+
+    for (const auto& define : defines)
+    {
+        key.defines.emplace_back(define.name);
+        key.defines.emplace_back(define.value);
+    }
+
+    return key;
+}
+
+auto ShaderVariantCache::create_variant(const ShaderPath& vertex_src_path,
+                                        const ShaderPath& fragment_src_path,
+                                        std::span<const ShaderDefine> defines) const
+    -> std::unique_ptr<Shader>
+{
+    PreprocessedShader vertex;
+    PreprocessedShader fragment;
+
+    try
+    {
+        vertex = _preprocessor.process(vertex_src_path, defines);
+        fragment = _preprocessor.process(fragment_src_path, defines);
+    }
+    catch (ShaderPreprocessError& e)
+    {
+        throw CreateShaderError{ e.what() };
+    }
+
+    auto vertex_name = vertex_src_path.string();
+    auto fragment_name = fragment_src_path.string();
+
+    ShaderSources sources = {
+        .vertex = vertex.source,
+        .fragment = fragment.source,
+        .vertex_name = vertex_name,
+        .fragment_name = fragment_name,
+    };
+
+    try
+    {
+        return std::make_unique<Shader>(sources, _binary_cache);
+    }
+    catch (CreateShaderError&)
+    {
+        // compiler messages refer to files by their number in the #line directives
+        for (usize i = 0; i < vertex.files.size(); i++)
+            log_error("vertex shader source string {}: {}", i, vertex.files[i].string());
+
+        for (usize i = 0; i < fragment.files.size(); i++)
+            log_error("fragment shader source string {}: {}", i, fragment.files[i].string());
+
+        throw;
+    }
+}
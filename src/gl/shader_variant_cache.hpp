@@ -0,0 +1,103 @@
+#pragma once
+
+#include <filesystem>
+
+#include "gl/program_pipeline.hpp"
+#include "gl/shader.hpp"
+#include "gl/shader_preprocessor.hpp"
+
+class ProgramBinaryCache;
+
+// Shaders specialized through #defines instead of uniforms and runtime branches. Each combination of
+// sources and defines is preprocessed and compiled the first time it's asked for and kept after that.
+//
+// Variants are looked up by a hash of the source paths and the defines and then compared against them, so
+// looking one up doesn't touch the files and colliding hashes can't return the wrong variant; the same
+// defines in a different order make a different variant. clear() after changing sources.
+class ShaderVariantCache
+{
+public:
+    using ShaderPath = std::filesystem::path;
+
+    // with a binary cache, variants compiled in earlier runs are loaded from it
+    explicit ShaderVariantCache(const ShaderPreprocessor& preprocessor,
+                                const ProgramBinaryCache* binary_cache = nullptr);
+
+    ShaderVariantCache(const ShaderVariantCache& other) = delete;
+    ShaderVariantCache(ShaderVariantCache&& other) = delete;
+
+    // a variant that fails to build isn't cached, the next call tries again
+    // throws CreateShaderError
+    auto get(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+             std::span<const ShaderDefine> defines = {}) -> Shader&;
+
+    // a separable stage for program pipelines, see ProgramPipelineCache; combining stage variants costs no
+    // links, unlike get()
+    // shader_type is GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+    // throws CreateShaderError, also for other shader types
+    auto get_stage(GLenum shader_type, const ShaderPath& src_path, std::span<const ShaderDefine> defines = {})
+        -> ShaderStage&;
+
+    // the hash get() looks a variant up by
+    [[nodiscard]] static auto make_key(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+                                       std::span<const ShaderDefine> defines) -> u64;
+
+    [[nodiscard]] inline auto size() const noexcept -> usize { return _variants.size() + _stages.size(); }
+    // pipelines using the stages have to be removed from their cache as well
+    inline auto clear() noexcept -> void
+    {
+        _variants.clear();
+        _stages.clear();
+    }
+
+private:
+    // everything a variant is built from; stages only use the first path
+    struct VariantKey
+    {
+        GLenum shader_type; // GL_NONE for programs from get()
+        ShaderPath first_src_path;
+        ShaderPath second_src_path;
+        std::vector<std::string> defines; // names and values, alternating
+
+        [[nodiscard]] auto matches(GLenum type, const ShaderPath& first, const ShaderPath& second,
+                                   std::span<const ShaderDefine> other_defines) const noexcept -> bool;
+    };
+
+    template<typename T>
+    using VariantMap = std::unordered_multimap<u64, std::pair<VariantKey, std::unique_ptr<T>>>;
+
+    // nullptr if there's no such variant
+    template<typename T>
+    [[nodiscard]] static auto find_variant(const VariantMap<T>& variants, u64 hash, GLenum shader_type,
+                                           const ShaderPath& first_src_path,
+                                           const ShaderPath& second_src_path,
+                                           std::span<const ShaderDefine> defines) noexcept -> T*
+    {
+        auto [first, last] = variants.equal_range(hash);
+
+        for (auto variant = first; variant != last; ++variant)
+        {
+            if (variant->second.first.matches(shader_type, first_src_path, second_src_path, defines))
+                return variant->second.second.get();
+        }
+
+        return nullptr;
+    }
+
+    [[nodiscard]] static auto hash_variant(GLenum shader_type, const ShaderPath& first_src_path,
+                                           const ShaderPath& second_src_path,
+                                           std::span<const ShaderDefine> defines) -> u64;
+    [[nodiscard]] static auto make_variant_key(GLenum shader_type, const ShaderPath& first_src_path,
+                                               const ShaderPath& second_src_path,
+                                               std::span<const ShaderDefine> defines) -> VariantKey;
+
+    // throws CreateShaderError
+    [[nodiscard]] auto create_variant(const ShaderPath& vertex_src_path, const ShaderPath& fragment_src_path,
+                                      std::span<const ShaderDefine> defines) const -> std::unique_ptr<Shader>;
+
+private:
+    const ShaderPreprocessor& _preprocessor;
+    const ProgramBinaryCache* _binary_cache;
+    VariantMap<Shader> _variants{};
+    VariantMap<ShaderStage> _stages{};
+};
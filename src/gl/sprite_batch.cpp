@@ -0,0 +1,140 @@
+#include "sprite_batch.hpp"
+
+#include "gl/shader.hpp"
+#include "gl/texture.hpp"
+#include "gl/vertex_buffer_layout.hpp"
+
+// room in each streaming buffer region for this many full batches before a frame has to wait for the GPU
+static constexpr usize full_flushes_per_frame = 2;
+
+// two counter-clockwise triangles per quad: bottom left, bottom right, top right, top left
+static constexpr std::array<GLushort, 6> quad_index_pattern = { 0, 1, 2, 0, 2, 3 };
+
+SpriteBatch::SpriteBatch(const Shader& shader, usize max_quads)
+    : _shader(shader), _max_quads(std::clamp(max_quads, usize{ 1 }, max_quads_per_draw)),
+      _vertices(GL_ARRAY_BUFFER, _max_quads * 4 * sizeof(SpriteVertex) * full_flushes_per_frame),
+      _indices(std::span<const GLushort>{ generate_quad_indices(_max_quads) }, GL_STATIC_DRAW)
+{
+    _vertices.bind();
+    bind_vertex_buffer_layout<SpriteVertex>();
+
+    GLint max_texture_units;
+    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &max_texture_units);
+    _texture_slot_count = std::min(static_cast<u32>(max_texture_units), max_texture_slots);
+
+    std::array<GLint, max_texture_slots> slots;
+    std::iota(slots.begin(), slots.end(), 0);
+
+    auto samplers = _shader.get_uniform<GLint>("samplers");
+    _shader.set_unif(samplers, std::span<const GLint>{ slots.data(), _texture_slot_count });
+    _projection_uniform = _shader.get_uniform<glm::mat4>("projection");
+
+    _staging.reserve(_max_quads * 4);
+}
+
+auto SpriteBatch::begin(const glm::mat4& projection) -> void
+{
+    _projection = projection;
+    _stats = {};
+    _vertices.begin_frame();
+}
+
+auto SpriteBatch::draw(const Texture2D& texture, const Sprite& sprite) -> void
+{
+    if (_staging.size() == _max_quads * 4)
+        flush();
+
+    auto slot = find_texture_slot(texture);
+
+    if (!slot)
+    {
+        flush();
+        slot = find_texture_slot(texture);
+    }
+
+    auto texture_slot = static_cast<GLfloat>(*slot);
+    auto [x, y] = sprite.position;
+    auto [width, height] = sprite.size;
+    auto [min_u, min_v, max_u, max_v] = sprite.uv_rect;
+
+    _staging.push_back({ { x, y }, { min_u, min_v }, sprite.color, texture_slot });
+    _staging.push_back({ { x + width, y }, { max_u, min_v }, sprite.color, texture_slot });
+    _staging.push_back({ { x + width, y + height }, { max_u, max_v }, sprite.color, texture_slot });
+    _staging.push_back({ { x, y + height }, { min_u, max_v }, sprite.color, texture_slot });
+}
+
+auto SpriteBatch::flush() -> void
+{
+    if (_staging.empty())
+        return;
+
+    auto data = std::as_bytes(std::span{ _staging });
+    auto allocation = _vertices.allocate(data.size(), sizeof(SpriteVertex));
+
+    // the region is full of this frame's earlier batches, move on to the next one
+    if (!allocation) [[unlikely]]
+    {
+        _vertices.end_frame();
+        _vertices.begin_frame();
+        allocation = _vertices.allocate(data.size(), sizeof(SpriteVertex));
+    }
+
+    std::ranges::copy(data, allocation->memory.begin());
+    _vertices.flush();
+
+    _shader.use();
+    _shader.set_unif(_projection_uniform, _projection);
+
+    for (u32 slot = 0; slot < _texture_count; slot++)
+        _textures[slot]->bind(slot);
+
+    auto quad_count = _staging.size() / 4;
+    auto base_vertex = static_cast<GLint>(static_cast<usize>(allocation->offset) / sizeof(SpriteVertex));
+
+    _vertex_array.bind();
+    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(quad_count * 6), GL_UNSIGNED_SHORT, nullptr,
+                             base_vertex);
+
+    _stats.quads += quad_count;
+    _stats.draw_calls++;
+
+    _staging.clear();
+    _texture_count = 0;
+}
+
+auto SpriteBatch::end() -> void
+{
+    flush();
+    _vertices.end_frame();
+}
+
+auto SpriteBatch::find_texture_slot(const Texture2D& texture) noexcept -> std::optional<u32>
+{
+    for (u32 slot = 0; slot < _texture_count; slot++)
+    {
+        if (_textures[slot] == &texture)
+            return slot;
+    }
+
+    if (_texture_count == _texture_slot_count)
+        return std::nullopt;
+
+    _textures[_texture_count] = &texture;
+    return _texture_count++;
+}
+
+auto SpriteBatch::generate_quad_indices(usize quad_count) -> std::vector<GLushort>
+{
+    std::vector<GLushort> indices;
+    indices.reserve(quad_count * 6);
+
+    for (usize quad = 0; quad < quad_count; quad++)
+    {
+        auto first = static_cast<GLushort>(quad * 4);
+
+        for (auto offset : quad_index_pattern)
+            indices.push_back(static_cast<GLushort>(first + offset));
+    }
+
+    return indices;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/index_buffer.hpp"
+#include "gl/streaming_buffer.hpp"
+#include "gl/uniform.hpp"
+#include "gl/vertex_array.hpp"
+
+class Shader;
+class Texture2D;
+
+struct SpriteVertex
+{
+    glm::vec2 position;
+    glm::vec2 tex_coords;
+    glm::vec4 color;
+    GLfloat texture_slot; // index into the shader's sampler array
+};
+
+struct Sprite
+{
+    glm::vec2 position; // bottom left corner
+    glm::vec2 size;
+    glm::vec4 uv_rect = { 0.0f, 0.0f, 1.0f, 1.0f }; // min u, min v, max u, max v
+    glm::vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+struct SpriteBatchStats
+{
+    usize quads = 0;
+    usize draw_calls = 0;
+};
+
+// Collects quads into a CPU staging array and draws them with as few glDrawElementsBaseVertex calls as
+// possible. Quads sharing up to max_texture_slots different textures go into the same draw call, a flush
+// only happens when the staging array is full, the texture slots run out, or at end().
+//
+// The shader has to follow shaders/sprite.vert and shaders/sprite.frag: SpriteVertex attributes, a
+// "projection" mat4 and a "samplers" sampler2D array.
+class SpriteBatch
+{
+public:
+    // indices are GLushort and every flush starts at index 0, so one draw can't have more quads than this
+    static constexpr usize max_quads_per_draw = 65536 / 4;
+    static constexpr u32 max_texture_slots = 16;
+
+    // max_quads is clamped to max_quads_per_draw
+    explicit SpriteBatch(const Shader& shader, usize max_quads = max_quads_per_draw);
+
+    SpriteBatch(const SpriteBatch& other) = delete;
+    SpriteBatch(SpriteBatch&& other) = delete;
+
+    auto begin(const glm::mat4& projection) -> void;
+    auto draw(const Texture2D& texture, const Sprite& sprite) -> void;
+    auto flush() -> void;
+    auto end() -> void;
+
+    // since the last begin()
+    [[nodiscard]] inline auto stats() const noexcept -> const SpriteBatchStats& { return _stats; }
+    [[nodiscard]] inline auto texture_slot_count() const noexcept -> u32 { return _texture_slot_count; }
+
+private:
+    // slot of the texture in the current batch, adding it if there's room
+    [[nodiscard]] auto find_texture_slot(const Texture2D& texture) noexcept -> std::optional<u32>;
+
+    [[nodiscard]] static auto generate_quad_indices(usize quad_count) -> std::vector<GLushort>;
+
+private:
+    const Shader& _shader;
+    usize _max_quads;
+    u32 _texture_slot_count;
+    UniformHandle<glm::mat4> _projection_uniform;
+    glm::mat4 _projection{};
+
+    std::vector<SpriteVertex> _staging{};
+    std::array<const Texture2D*, max_texture_slots> _textures{};
+    u32 _texture_count = 0;
+    SpriteBatchStats _stats{};
+
+    // the vertex array has to exist before the buffers so their bindings are recorded in it
+    VertexArray _vertex_array{};
+    StreamingBuffer _vertices;
+    IndexBuffer _indices;
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+#include "core/glm_concepts.hpp"
+#include "core/struct_reflection.hpp"
+
+// The std140 and std430 block layouts, computed at compile time for plain C++ types, so blocks can be
+// declared as ordinary structs without any manual padding. Values are written field by field to the
+// offsets GLSL expects, which also keeps alignas or packing differences in the C++ struct from mattering.
+//
+// Supported fields: 4-byte scalars (GLfloat, GLint, GLuint), glm vectors and float matrices of them,
+// std::array of any supported type and nested aggregates. bool isn't supported, it's 4 bytes in GLSL.
+
+enum class StdLayout
+{
+    std140,
+    std430,
+};
+
+struct StdLayoutInfo
+{
+    usize size;
+    usize alignment;
+};
+
+template<typename T> struct IsStdArray : std::false_type
+{
+};
+
+template<typename T, usize n> struct IsStdArray<std::array<T, n>> : std::true_type
+{
+};
+
+template<typename T>
+concept StdLayoutScalar = std::same_as<T, GLfloat> || std::same_as<T, GLint> || std::same_as<T, GLuint>;
+
+template<typename T>
+concept StdLayoutStruct = std::is_aggregate_v<T> && !IsStdArray<T>::value && !GlmVector<T> && !GlmMatrix<T>;
+
+template<typename T>
+concept StdLayoutStructArray = IsStdArray<T>::value && StdLayoutStruct<typename T::value_type>;
+
+// whether T can be laid out in std140 and std430 at all, see the supported fields above
+template<typename T> consteval inline auto is_std_layout_type() -> bool
+{
+    if constexpr (StdLayoutScalar<T>)
+    {
+        return true;
+    }
+    else if constexpr (GlmVector<T>)
+    {
+        return StdLayoutScalar<typename T::value_type>;
+    }
+    else if constexpr (GlmMatrix<T>)
+    {
+        return std::same_as<typename T::value_type, GLfloat>;
+    }
+    else if constexpr (IsStdArray<T>::value)
+    {
+        return is_std_layout_type<typename T::value_type>();
+    }
+    else if constexpr (StdLayoutStruct<T>)
+    {
+        if constexpr (get_struct_arity<T>() > max_reflected_struct_arity)
+            return false;
+        else
+            return []<typename... Fields>(std::type_identity<std::tuple<Fields...>>) {
+                return (is_std_layout_type<Fields>() && ...);
+            }(std::type_identity<StructFieldTypes<T>>{});
+    }
+    else
+    {
+        return false;
+    }
+}
+
+template<typename T>
+concept StdLayoutType = is_std_layout_type<T>();
+
+[[nodiscard]] constexpr inline auto std_layout_align_up(usize value, usize alignment) noexcept -> usize
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// std140 rounds the alignment of arrays and structs up to that of a vec4
+template<StdLayout layout>
+[[nodiscard]] constexpr inline auto std_layout_round_alignment(usize alignment) noexcept -> usize
+{
+    return layout == StdLayout::std140 ? std::max<usize>(alignment, 16) : alignment;
+}
+
+template<StdLayout layout, typename T> consteval inline auto get_std_layout_info() -> StdLayoutInfo;
+
+// distance between consecutive elements of an array of T
+template<StdLayout layout, typename T> consteval inline auto get_std_layout_array_stride() -> usize
+{
+    constexpr auto element = get_std_layout_info<layout, T>();
+    return std_layout_align_up(element.size, std_layout_round_alignment<layout>(element.alignment));
+}
+
+// offsets of the fields of a struct, in declaration order
+template<StdLayout layout, StdLayoutStruct T> consteval inline auto get_std_layout_offsets()
+{
+    using Fields = StructFieldTypes<T>;
+
+    return [&]<usize... indices>(std::index_sequence<indices...>) {
+        std::array<usize, sizeof...(indices)> offsets{};
+        usize offset = 0;
+
+        ((offset = std_layout_align_up(
+              offset, get_std_layout_info<layout, std::tuple_element_t<indices, Fields>>().alignment),
+          offsets[indices] = offset,
+          offset += get_std_layout_info<layout, std::tuple_element_t<indices, Fields>>().size),
+         ...);
+
+        return offsets;
+    }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+}
+
+template<StdLayout layout, typename T> consteval inline auto get_std_layout_info() -> StdLayoutInfo
+{
+    if constexpr (StdLayoutScalar<T>)
+    {
+        return { .size = 4, .alignment = 4 };
+    }
+    else if constexpr (GlmVector<T>)
+    {
+        static_assert(StdLayoutScalar<typename T::value_type>, "not implemented");
+        constexpr usize length = T::length();
+
+        // a vec3 is aligned like a vec4 but only 12 bytes big, a scalar can follow it directly
+        return { .size = 4 * length, .alignment = length == 3 ? 16 : 4 * length };
+    }
+    else if constexpr (GlmMatrix<T>)
+    {
+        static_assert(std::same_as<typename T::value_type, GLfloat>, "not implemented");
+
+        // column-major, laid out like an array of its columns
+        using Column = typename T::col_type;
+        constexpr usize columns = T::length();
+        constexpr auto column = get_std_layout_info<layout, Column>();
+
+        return {
+            .size = get_std_layout_array_stride<layout, Column>() * columns,
+            .alignment = std_layout_round_alignment<layout>(column.alignment),
+        };
+    }
+    else if constexpr (IsStdArray<T>::value)
+    {
+        using Element = typename T::value_type;
+        constexpr auto element = get_std_layout_info<layout, Element>();
+
+        return {
+            .size = get_std_layout_array_stride<layout, Element>() * std::tuple_size_v<T>,
+            .alignment = std_layout_round_alignment<layout>(element.alignment),
+        };
+    }
+    else if constexpr (StdLayoutStruct<T>)
+    {
+        using Fields = StructFieldTypes<T>;
+        constexpr auto offsets = get_std_layout_offsets<layout, T>();
+
+        return [&]<usize... indices>(std::index_sequence<indices...>) -> StdLayoutInfo {
+            usize alignment = std_layout_round_alignment<layout>(
+                std::max({ usize{ 4 }, get_std_layout_info<layout, std::tuple_element_t<indices, Fields>>()
+                                           .alignment... }));
+            usize end = 0;
+
+            if constexpr (sizeof...(indices) != 0)
+            {
+                constexpr auto last = sizeof...(indices) - 1;
+                end = offsets[last] + get_std_layout_info<layout, std::tuple_element_t<last, Fields>>().size;
+            }
+
+            return { .size = std_layout_align_up(end, alignment), .alignment = alignment };
+        }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+    }
+    else
+    {
+        static_assert(false, "not implemented");
+    }
+}
+
+// writes value to destination in the given layout; destination has to be get_std_layout_info().size big
+template<StdLayout layout, typename T>
+inline auto write_std_layout(const T& value, std::span<std::byte> destination) noexcept -> void
+{
+    if constexpr (StdLayoutScalar<T> || GlmVector<T>)
+    {
+        std::memcpy(destination.data(), &value, sizeof(T));
+    }
+    else if constexpr (GlmMatrix<T>)
+    {
+        using Column = typename T::col_type;
+        constexpr auto stride = get_std_layout_array_stride<layout, Column>();
+
+        for (glm::length_t i = 0; i < T::length(); i++)
+            write_std_layout<layout>(value[i], destination.subspan(static_cast<usize>(i) * stride));
+    }
+    else if constexpr (IsStdArray<T>::value)
+    {
+        constexpr auto stride = get_std_layout_array_stride<layout, typename T::value_type>();
+
+        for (usize i = 0; i < value.size(); i++)
+            write_std_layout<layout>(value[i], destination.subspan(i * stride));
+    }
+    else if constexpr (StdLayoutStruct<T>)
+    {
+        constexpr auto offsets = get_std_layout_offsets<layout, T>();
+        usize field_index = 0;
+
+        for_each_struct_field(value, [&](const auto& field) {
+            write_std_layout<layout>(field, destination.subspan(offsets[field_index++]));
+        });
+    }
+    else
+    {
+        static_assert(false, "not implemented");
+    }
+}
+
+// Offsets of every member GL reflection reports for a block of this type: arrays of structs are
+// expanded per element, arrays of anything else and matrices are a single member.
+template<StdLayout layout, typename T>
+inline auto collect_std_layout_member_offsets(std::vector<usize>& offsets, usize base = 0) -> void
+{
+    if constexpr (StdLayoutStructArray<T>)
+    {
+        constexpr auto stride = get_std_layout_array_stride<layout, typename T::value_type>();
+
+        for (usize i = 0; i < std::tuple_size_v<T>; i++)
+            collect_std_layout_member_offsets<layout, typename T::value_type>(offsets, base + i * stride);
+    }
+    else if constexpr (StdLayoutStruct<T>)
+    {
+        using Fields = StructFieldTypes<T>;
+        constexpr auto field_offsets = get_std_layout_offsets<layout, T>();
+
+        [&]<usize... indices>(std::index_sequence<indices...>) {
+            (collect_std_layout_member_offsets<layout, std::tuple_element_t<indices, Fields>>(
+                 offsets, base + field_offsets[indices]),
+             ...);
+        }(std::make_index_sequence<std::tuple_size_v<Fields>>{});
+    }
+    else
+    {
+        offsets.push_back(base);
+    }
+}
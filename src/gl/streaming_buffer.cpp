@@ -0,0 +1,125 @@
+#include "streaming_buffer.hpp"
+
+#include "core/log.hpp"
+#include "gl/gl_extensions.hpp"
+
+static constexpr usize region_alignment = 256;
+static constexpr GLuint64 fence_timeout_ns = 1'000'000'000;
+
+[[nodiscard]] static inline auto align_up(usize value, usize alignment) noexcept -> usize
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+StreamingBuffer::StreamingBuffer(GLenum target, usize frame_size, u32 frame_count)
+    : _target(target), _frame_size(align_up(frame_size, region_alignment)), _fences(frame_count, nullptr)
+{
+    auto buffer_size = static_cast<GLsizeiptr>(_frame_size * frame_count);
+
+    glGenBuffers(1, &_id);
+    bind();
+
+    if (auto buffer_storage = gl_extensions().buffer_storage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        buffer_storage(_target, buffer_size, nullptr, flags);
+        _mapping = static_cast<std::byte*>(glMapBufferRange(_target, 0, buffer_size, flags));
+
+        // immutable storage without GL_DYNAMIC_STORAGE_BIT can't be written with glBufferSubData, the
+        // fallback needs a buffer of its own
+        if (!_mapping) [[unlikely]]
+        {
+            log_warning("Can't map streaming buffer persistently, falling back to glBufferSubData");
+            gl_state().delete_buffer(_id);
+            glGenBuffers(1, &_id);
+            bind();
+        }
+    }
+
+    if (!_mapping)
+    {
+        glBufferData(_target, buffer_size, nullptr, GL_STREAM_DRAW);
+        _staging = std::make_unique_for_overwrite<std::byte[]>(_frame_size);
+    }
+}
+
+StreamingBuffer::~StreamingBuffer() noexcept
+{
+    for (auto fence : _fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    if (_mapping)
+    {
+        bind();
+        glUnmapBuffer(_target);
+    }
+
+    gl_state().delete_buffer(_id);
+}
+
+auto StreamingBuffer::begin_frame() noexcept -> void
+{
+    auto& fence = _fences[_current_frame];
+
+    if (fence)
+    {
+        // only blocks if the CPU got frame_count frames ahead of the GPU; only the first wait has to flush
+        auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fence_timeout_ns);
+
+        while (result == GL_TIMEOUT_EXPIRED)
+            result = glClientWaitSync(fence, 0, fence_timeout_ns);
+
+        // the region may still be read from, wait for all GPU work instead
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) [[unlikely]]
+            glFinish();
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    _frame_offset = 0;
+    _flushed_offset = 0;
+}
+
+auto StreamingBuffer::allocate(usize size, usize alignment) noexcept -> std::optional<StreamingAllocation>
+{
+    // aligned within the whole buffer, not just the region, so offset / sizeof(Vertex) can be a base vertex
+    auto offset = align_up(region_start() + _frame_offset, alignment) - region_start();
+
+    if (offset + size > _frame_size) [[unlikely]]
+        return std::nullopt;
+
+    _frame_offset = offset + size;
+
+    auto memory = _mapping ? _mapping + region_start() + offset : _staging.get() + offset;
+
+    return StreamingAllocation{
+        .memory = { memory, size },
+        .offset = static_cast<GLintptr>(region_start() + offset),
+    };
+}
+
+auto StreamingBuffer::flush() noexcept -> void
+{
+    // coherent persistent mappings need no flushing at all
+    if (_mapping || _flushed_offset == _frame_offset)
+        return;
+
+    bind();
+    auto size = _frame_offset - _flushed_offset;
+    glBufferSubData(_target, static_cast<GLintptr>(region_start() + _flushed_offset),
+                    static_cast<GLsizeiptr>(size), _staging.get() + _flushed_offset);
+
+    _flushed_offset = _frame_offset;
+}
+
+auto StreamingBuffer::end_frame() noexcept -> void
+{
+    flush();
+
+    _fences[_current_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _current_frame = (_current_frame + 1) % static_cast<u32>(_fences.size());
+}
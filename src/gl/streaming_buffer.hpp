@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/gl_state.hpp"
+
+struct StreamingAllocation
+{
+    std::span<std::byte> memory; // write here
+    GLintptr offset;             // and source from here in GL calls (attribute offsets, base vertex, ...)
+
+    template<typename T> [[nodiscard]] inline auto as() const noexcept -> std::span<T>
+    {
+        return { reinterpret_cast<T*>(memory.data()), memory.size() / sizeof(T) };
+    }
+};
+
+// Buffer for geometry that's rewritten every frame. Storage is split into frame_count regions; the CPU
+// writes into one region while the GPU still reads from the others, and each region is guarded by a fence,
+// so the CPU only ever waits if it gets frame_count frames ahead.
+//
+// With GL 4.4 / ARB_buffer_storage the buffer is mapped once, persistently and coherently, and allocations
+// point straight into GPU-visible memory. Without it, or if mapping fails, allocations point into a CPU
+// staging copy of the region, which flush() uploads with a single glBufferSubData.
+//
+// Usage per frame: begin_frame(), allocate() and write, flush(), draw, end_frame().
+class StreamingBuffer
+{
+public:
+    explicit StreamingBuffer(GLenum target, usize frame_size, u32 frame_count = 3);
+    ~StreamingBuffer() noexcept;
+
+    StreamingBuffer(const StreamingBuffer& other) = delete;
+    StreamingBuffer(StreamingBuffer&& other) = delete;
+
+    // waits until the GPU is done with the region about to be reused
+    auto begin_frame() noexcept -> void;
+    // returns nullopt if the current frame's region is full; alignment doesn't have to be a power of two,
+    // with alignment = sizeof(Vertex) the allocation's offset / sizeof(Vertex) is a valid base vertex
+    [[nodiscard]] auto allocate(usize size, usize alignment = 16) noexcept
+        -> std::optional<StreamingAllocation>;
+    // makes everything allocated since the last flush visible to the GPU
+    auto flush() noexcept -> void;
+    // fences the current region
+    auto end_frame() noexcept -> void;
+
+    template<typename T>
+    [[nodiscard]] inline auto allocate(usize count) noexcept -> std::optional<StreamingAllocation>
+    {
+        return allocate(count * sizeof(T), alignof(T));
+    }
+
+    inline auto bind() const noexcept -> void { gl_state().bind_buffer(_target, _id); }
+    [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
+    [[nodiscard]] inline auto frame_size() const noexcept -> usize { return _frame_size; }
+    [[nodiscard]] inline auto is_persistently_mapped() const noexcept -> bool { return _mapping != nullptr; }
+
+    // bytes allocated in the current frame
+    [[nodiscard]] inline auto used() const noexcept -> usize { return _frame_offset; }
+
+private:
+    [[nodiscard]] inline auto region_start() const noexcept -> usize { return _current_frame * _frame_size; }
+
+private:
+    GLuint _id;
+    GLenum _target;
+    usize _frame_size;
+    u32 _current_frame = 0;
+    usize _frame_offset = 0;
+    usize _flushed_offset = 0;
+    std::vector<GLsync> _fences;
+
+    std::byte* _mapping = nullptr;              // persistent mapping of the whole buffer
+    std::unique_ptr<std::byte[]> _staging = {}; // used without buffer storage, one region big
+};
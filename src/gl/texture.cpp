@@ -1,8 +1,11 @@
 #include "texture.hpp"
 
-#include <stb_image.h>
+#include <bit>
 
 #include "core/log.hpp"
+#include "io/asset_archive.hpp"
+#include "io/image.hpp"
+#include "io/mapped_file.hpp"
 
 auto Texture2DOptions::apply() const noexcept -> void
 {
@@ -29,28 +32,113 @@ auto Texture2DOptions::apply() const noexcept -> void
     std::unreachable();
 }
 
+[[nodiscard]] static inline auto get_sized_format_from_channels(u32 channels) noexcept -> GLenum
+{
+    switch (channels)
+    {
+    case 1:
+        return GL_R8;
+    case 2:
+        return GL_RG8;
+    case 3:
+        return GL_RGB8;
+    case 4:
+        return GL_RGBA8;
+    }
+
+    std::unreachable();
+}
+
 Texture2D::Texture2D(const std::filesystem::path& path, bool generate_mipmap, const Texture2DOptions* options)
 {
-    if (!std::filesystem::exists(path)) [[unlikely]]
+    std::optional<MappedFile> file;
+
+    try
+    {
+        file.emplace(path);
+    }
+    catch (FileIoError& e)
     {
-        auto message = std::format("Can't create texture: Invalid file path: {}", path.string());
+        auto message = std::format("Can't create texture: {}", e.what());
         log_error("{}", message);
         throw CreateTextureError{ message };
     }
 
-    stbi_set_flip_vertically_on_load(true);
-    auto path_str = path.string();
+    create_from_memory(file->bytes(), path.string(), generate_mipmap, options);
+}
 
-    int width, height, channels;
-    auto data = stbi_load(path_str.c_str(), &width, &height, &channels, 0);
+Texture2D::Texture2D(const AssetArchive& archive, const std::filesystem::path& path, bool generate_mipmap,
+                     const Texture2DOptions* options)
+{
+    auto file_data = archive.find(path);
 
-    if (!data) [[unlikely]]
+    if (!file_data) [[unlikely]]
     {
-        auto message = std::format("Can't create texture: Can't read texture file: {}", path_str);
+        auto message = std::format("Can't create texture: Invalid file path: {} (in archive {})",
+                                   path.string(), archive.path().string());
         log_error("{}", message);
         throw CreateTextureError{ message };
     }
 
+    create_from_memory(*file_data, path.string(), generate_mipmap, options);
+}
+
+Texture2D::Texture2D(const Image& image, bool generate_mipmap, const Texture2DOptions* options)
+{
+    create_from_image(image, generate_mipmap, options);
+}
+
+Texture2D::Texture2D(u32 width, u32 height, u32 channels, u32 mip_levels, const Texture2DOptions* options)
+    : _width(width), _height(height), _channels(channels)
+{
+    create(options);
+    _internal_format = get_format_from_channels(channels);
+
+    glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(mip_levels), get_sized_format_from_channels(channels),
+                   static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+}
+
+auto Texture2D::mip_level_count(u32 width, u32 height) noexcept -> u32
+{
+    return std::bit_width(std::max({ width, height, 1u }));
+}
+
+auto Texture2D::create_from_memory(std::span<const std::byte> file_data, std::string_view name,
+                                   bool generate_mipmap, const Texture2DOptions* options) -> void
+{
+    try
+    {
+        Image image(file_data);
+        create_from_image(image, generate_mipmap, options);
+    }
+    catch (DecodeImageError& e)
+    {
+        auto message = std::format("Can't create texture: Can't read texture file: {}: {}", name, e.what());
+        log_error("{}", message);
+        throw CreateTextureError{ message };
+    }
+}
+
+auto Texture2D::create_from_image(const Image& image, bool generate_mipmap, const Texture2DOptions* options)
+    -> void
+{
+    _width = image.width();
+    _height = image.height();
+    _channels = image.channels();
+
+    create(options);
+    _internal_format = get_format_from_channels(image.channels());
+
+    glTexImage2D(GL_TEXTURE_2D, 0, _internal_format, static_cast<GLsizei>(image.width()),
+                 static_cast<GLsizei>(image.height()), 0, static_cast<GLenum>(_internal_format),
+                 GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(image.pixels().data()));
+
+    if (generate_mipmap)
+        glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+auto Texture2D::create(const Texture2DOptions* options) -> void
+{
     glGenTextures(1, &_id);
     bind();
 
@@ -63,21 +151,9 @@ Texture2D::Texture2D(const std::filesystem::path& path, bool generate_mipmap, co
         Texture2DOptions default_opts;
         default_opts.apply();
     }
-
-    _internal_format = get_format_from_channels(channels);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, _internal_format, static_cast<GLsizei>(width),
-                 static_cast<GLsizei>(height), 0, _internal_format, GL_UNSIGNED_BYTE,
-                 reinterpret_cast<const void*>(data));
-
-    if (generate_mipmap)
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-    stbi_image_free(data);
 }
 
 auto Texture2D::bind(u32 slot) const noexcept -> void
 {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, _id);
+    gl_state().bind_texture(slot, GL_TEXTURE_2D, _id);
 }
@@ -4,6 +4,11 @@
 
 #include <filesystem>
 
+#include "gl/gl_state.hpp"
+
+class AssetArchive;
+class Image;
+
 struct Texture2DOptions
 {
     GLint horizontal_wrap = GL_REPEAT;
@@ -19,7 +24,14 @@ class Texture2D
 public:
     explicit Texture2D(const std::filesystem::path& path, bool generate_mipmap = true,
                        const Texture2DOptions* options = nullptr);
-    inline ~Texture2D() noexcept { glDeleteTextures(1, &_id); }
+    explicit Texture2D(const AssetArchive& archive, const std::filesystem::path& path,
+                       bool generate_mipmap = true, const Texture2DOptions* options = nullptr);
+    explicit Texture2D(const Image& image, bool generate_mipmap = true,
+                       const Texture2DOptions* options = nullptr);
+    // allocates immutable storage without any contents, to be filled with e.g. TextureUploader
+    explicit Texture2D(u32 width, u32 height, u32 channels, u32 mip_levels = 1,
+                       const Texture2DOptions* options = nullptr);
+    inline ~Texture2D() noexcept { gl_state().delete_texture(_id); }
 
     Texture2D(const Texture2D& other) = delete;
     Texture2D(Texture2D&& other) = delete;
@@ -27,10 +39,25 @@ public:
     auto bind(u32 slot = 0) const noexcept -> void;
     [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
     [[nodiscard]] inline auto internal_format() const noexcept -> GLint { return _internal_format; }
+    [[nodiscard]] inline auto width() const noexcept -> u32 { return _width; }
+    [[nodiscard]] inline auto height() const noexcept -> u32 { return _height; }
+    [[nodiscard]] inline auto channels() const noexcept -> u32 { return _channels; }
+
+    // number of levels of a full mipmap chain
+    [[nodiscard]] static auto mip_level_count(u32 width, u32 height) noexcept -> u32;
+
+private:
+    auto create_from_memory(std::span<const std::byte> file_data, std::string_view name, bool generate_mipmap,
+                            const Texture2DOptions* options) -> void;
+    auto create_from_image(const Image& image, bool generate_mipmap, const Texture2DOptions* options) -> void;
+    auto create(const Texture2DOptions* options) -> void;
 
 private:
     GLuint _id;
     GLint _internal_format;
+    u32 _width = 0;
+    u32 _height = 0;
+    u32 _channels = 0;
 };
 
 class CreateTextureError : public std::runtime_error
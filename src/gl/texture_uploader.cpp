@@ -0,0 +1,169 @@
+#include "texture_uploader.hpp"
+
+#include "core/log.hpp"
+#include "gl/gl_state.hpp"
+#include "io/image.hpp"
+
+static constexpr GLuint64 fence_timeout_ns = 1'000'000'000;
+
+TextureUploader::TextureUploader(usize slot_size, u32 slot_count) : _slot_size(slot_size), _slots(slot_count)
+{
+    for (auto& slot : _slots)
+    {
+        glGenBuffers(1, &slot.buffer);
+        gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(_slot_size), nullptr, GL_STREAM_DRAW);
+    }
+
+    gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+TextureUploader::~TextureUploader() noexcept
+{
+    for (auto& slot : _slots)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+
+        gl_state().delete_buffer(slot.buffer);
+    }
+}
+
+auto TextureUploader::upload(const Texture2D& texture, const Image& image, bool generate_mipmap) -> void
+{
+    upload(texture, { .width = image.width(), .height = image.height() }, image.pixels());
+
+    if (generate_mipmap)
+    {
+        texture.bind();
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+}
+
+auto TextureUploader::upload(const Texture2D& texture, const TextureUploadRegion& region,
+                             std::span<const u8> pixels) -> void
+{
+    usize row_size = static_cast<usize>(region.width) * texture.channels();
+
+    if (row_size == 0 || region.height == 0)
+        return;
+
+    auto rows_per_band = static_cast<u32>(std::min<usize>(_slot_size / row_size, region.height));
+
+    if (rows_per_band == 0) [[unlikely]]
+    {
+        auto message = std::format("Can't upload texture: a row of {} bytes doesn't fit in a {} byte slot",
+                                   row_size, _slot_size);
+        throw TextureUploadError{ message };
+    }
+
+    if (pixels.size() < region.height * row_size) [[unlikely]]
+    {
+        auto message = std::format("Can't upload texture: {} bytes of pixels for a {}x{} region of {} bytes",
+                                   pixels.size(), region.width, region.height, region.height * row_size);
+        log_error("{}", message);
+        throw TextureUploadError{ message };
+    }
+
+    for (u32 first_row = 0; first_row < region.height; first_row += rows_per_band)
+    {
+        auto band = region;
+        band.y = region.y + first_row;
+        band.height = std::min(rows_per_band, region.height - first_row);
+
+        auto band_pixels = pixels.subspan(first_row * row_size, band.height * row_size);
+        auto destination = begin_upload(texture, band);
+        std::ranges::copy(band_pixels, destination.begin());
+        end_upload(texture);
+    }
+}
+
+auto TextureUploader::begin_upload(const Texture2D& texture, const TextureUploadRegion& region)
+    -> std::span<u8>
+{
+    usize size = static_cast<usize>(region.width) * region.height * texture.channels();
+
+    if (size > _slot_size) [[unlikely]]
+    {
+        auto message = std::format("Can't upload texture: region of {} bytes doesn't fit in a {} byte slot",
+                                   size, _slot_size);
+        throw TextureUploadError{ message };
+    }
+
+    gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, _slots[_current_slot].buffer);
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+
+    // Once the fence signaled the GPU is done with this buffer, so the driver doesn't have to synchronize.
+    // If waiting failed, the buffer is orphaned instead: the driver hands out fresh memory and frees the
+    // old one once the GPU is done reading it.
+    if (wait_for_slot(_current_slot)) [[likely]]
+        access |= GL_MAP_UNSYNCHRONIZED_BIT;
+    else
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(_slot_size), nullptr, GL_STREAM_DRAW);
+
+    auto mapping = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size), access);
+
+    if (!mapping) [[unlikely]]
+    {
+        gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        auto message = std::format("Can't upload texture: mapping a {} byte pixel buffer failed", size);
+        log_error("{}", message);
+        throw TextureUploadError{ message };
+    }
+
+    _pending_region = region;
+    return { static_cast<u8*>(mapping), size };
+}
+
+auto TextureUploader::end_upload(const Texture2D& texture) -> void
+{
+    if (!_pending_region) [[unlikely]]
+    {
+        const char* message = "Can't upload texture: end_upload() without begin_upload()";
+        log_error("{}", message);
+        throw TextureUploadError{ message };
+    }
+
+    auto region = *_pending_region;
+    _pending_region.reset();
+
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    GLint previous_alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previous_alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    texture.bind();
+    glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(region.mip_level), static_cast<GLint>(region.x),
+                    static_cast<GLint>(region.y), static_cast<GLsizei>(region.width),
+                    static_cast<GLsizei>(region.height), static_cast<GLenum>(texture.internal_format()),
+                    GL_UNSIGNED_BYTE, nullptr);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previous_alignment);
+
+    // leaving a PBO bound would turn every later client-memory upload into a PBO offset
+    gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    _slots[_current_slot].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _current_slot = (_current_slot + 1) % static_cast<u32>(_slots.size());
+}
+
+auto TextureUploader::wait_for_slot(u32 slot) noexcept -> bool
+{
+    auto& fence = _slots[slot].fence;
+
+    if (!fence)
+        return true;
+
+    // usually already signaled, the ring is a few uploads deep; only the first wait has to flush
+    auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fence_timeout_ns);
+
+    while (result == GL_TIMEOUT_EXPIRED)
+        result = glClientWaitSync(fence, 0, fence_timeout_ns);
+
+    glDeleteSync(fence);
+    fence = nullptr;
+
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
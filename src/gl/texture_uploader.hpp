@@ -0,0 +1,74 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/texture.hpp"
+
+class Image;
+
+struct TextureUploadRegion
+{
+    u32 x = 0;
+    u32 y = 0;
+    u32 width;
+    u32 height;
+    u32 mip_level = 0;
+};
+
+// Streams pixels into textures through a ring of pixel buffer objects. Pixels are written straight into
+// mapped PBO memory and glTexSubImage2D reads them from the PBO, so the copy into the texture happens
+// asynchronously instead of stalling the calling thread. Every PBO is guarded by a fence and only reused
+// once the GPU is done reading from it.
+class TextureUploader
+{
+public:
+    static constexpr usize default_slot_size = 4 * 1024 * 1024;
+    static constexpr u32 default_slot_count = 3;
+
+    explicit TextureUploader(usize slot_size = default_slot_size, u32 slot_count = default_slot_count);
+    ~TextureUploader() noexcept;
+
+    TextureUploader(const TextureUploader& other) = delete;
+    TextureUploader(TextureUploader&& other) = delete;
+
+    // images bigger than a slot are streamed in bands of rows
+    // pixels have to be tightly packed and have as many channels as the texture
+    // throws TextureUploadError, also if there are fewer pixels than the region covers
+    auto upload(const Texture2D& texture, const Image& image, bool generate_mipmap = false) -> void;
+    // throws TextureUploadError
+    auto upload(const Texture2D& texture, const TextureUploadRegion& region, std::span<const u8> pixels)
+        -> void;
+
+    // lower-level interface for producers that can write pixels directly into the PBO (e.g. a decoder)
+    // the returned memory is valid until end_upload()
+    // throws TextureUploadError if the region doesn't fit in a slot or the PBO can't be mapped
+    [[nodiscard]] auto begin_upload(const Texture2D& texture, const TextureUploadRegion& region)
+        -> std::span<u8>;
+    // throws TextureUploadError if there's no pending begin_upload()
+    auto end_upload(const Texture2D& texture) -> void;
+
+    [[nodiscard]] inline auto slot_size() const noexcept -> usize { return _slot_size; }
+
+private:
+    // false if waiting for the GPU to be done with the slot failed, e.g. after a context loss
+    [[nodiscard]] auto wait_for_slot(u32 slot) noexcept -> bool;
+
+private:
+    struct Slot
+    {
+        GLuint buffer;
+        GLsync fence = nullptr;
+    };
+
+    usize _slot_size;
+    std::vector<Slot> _slots;
+    u32 _current_slot = 0;
+    std::optional<TextureUploadRegion> _pending_region{};
+};
+
+class TextureUploadError : public std::runtime_error
+{
+public:
+    inline TextureUploadError(const char* message) noexcept : std::runtime_error(message) {}
+    inline TextureUploadError(const std::string& message) noexcept : std::runtime_error(message) {}
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+// an active uniform outside of any block, as reflected after linking
+struct UniformInfo
+{
+    std::string name; // arrays without the "[0]" suffix GL reports them with
+    GLint location;
+    GLenum type;
+    GLint array_size;
+};
+
+// an active uniform or shader storage block, as reflected after linking
+struct BufferBlockInfo
+{
+    std::string name;
+    GLuint index;
+    GLuint binding;
+    GLint data_size;                   // the smallest buffer (range) the block can be backed by
+    std::vector<GLint> member_offsets; // sorted, arrays of structs have one member per element and field
+    // of the first member, shader storage blocks only; a top level array of structs only has the members
+    // of its first element reflected, this is the distance to the next one
+    GLint top_level_array_stride = 0;
+};
+
+struct UniformStats
+{
+    u64 issued_calls = 0;
+    u64 skipped_calls = 0; // the uniform already had the value
+};
+
+// Resolved once through Shader::get_uniform(), after which setting the uniform is a plain GL call with no
+// lookup. A default constructed handle, or one for a uniform that doesn't exist, is invalid; setting it is
+// a no-op, just like location -1 in GL. So is setting a handle from another program, including the one a
+// shader had before Shader::replace_program.
+template<typename T> struct UniformHandle
+{
+    static constexpr u32 invalid_index = std::numeric_limits<u32>::max();
+
+    u32 index = invalid_index; // into the shader's uniform table
+    GLint location = -1;
+    u32 program_generation = 0; // of the shader it was looked up on, never 0 for a shader
+
+    [[nodiscard]] inline auto is_valid() const noexcept -> bool { return index != invalid_index; }
+};
+
+// the GL type a uniform needs to have to be set from a T; samplers are also set from GLint
+template<typename T> consteval inline auto get_uniform_type() -> GLenum
+{
+    if constexpr (std::same_as<T, GLfloat>)
+        return GL_FLOAT;
+    else if constexpr (std::same_as<T, glm::vec2>)
+        return GL_FLOAT_VEC2;
+    else if constexpr (std::same_as<T, glm::vec3>)
+        return GL_FLOAT_VEC3;
+    else if constexpr (std::same_as<T, glm::vec4>)
+        return GL_FLOAT_VEC4;
+    else if constexpr (std::same_as<T, GLint>)
+        return GL_INT;
+    else if constexpr (std::same_as<T, glm::ivec2>)
+        return GL_INT_VEC2;
+    else if constexpr (std::same_as<T, glm::ivec3>)
+        return GL_INT_VEC3;
+    else if constexpr (std::same_as<T, glm::ivec4>)
+        return GL_INT_VEC4;
+    else if constexpr (std::same_as<T, GLuint>)
+        return GL_UNSIGNED_INT;
+    else if constexpr (std::same_as<T, glm::mat3>)
+        return GL_FLOAT_MAT3;
+    else if constexpr (std::same_as<T, glm::mat4>)
+        return GL_FLOAT_MAT4;
+    else
+        static_assert(false, "not implemented");
+}
+
+template<typename T>
+inline auto set_program_uniform(GLuint program, GLint location, std::span<const T> values) noexcept -> void
+{
+    if (values.empty())
+        return;
+
+    auto count = static_cast<GLsizei>(values.size());
+
+    if constexpr (std::same_as<T, GLfloat>)
+        glProgramUniform1fv(program, location, count, values.data());
+    else if constexpr (std::same_as<T, glm::vec2>)
+        glProgramUniform2fv(program, location, count, glm::value_ptr(values[0]));
+    else if constexpr (std::same_as<T, glm::vec3>)
+        glProgramUniform3fv(program, location, count, glm::value_ptr(values[0]));
+    else if constexpr (std::same_as<T, glm::vec4>)
+        glProgramUniform4fv(program, location, count, glm::value_ptr(values[0]));
+    else if constexpr (std::same_as<T, GLint>)
+        glProgramUniform1iv(program, location, count, values.data());
+    else if constexpr (std::same_as<T, glm::ivec2>)
+        glProgramUniform2iv(program, location, count, glm::value_ptr(values[0]));
+    else if constexpr (std::same_as<T, glm::ivec3>)
+        glProgramUniform3iv(program, location, count, glm::value_ptr(values[0]));
+    else if constexpr (std::same_as<T, glm::ivec4>)
+        glProgramUniform4iv(program, location, count, glm::value_ptr(values[0]));
+    else if constexpr (std::same_as<T, GLuint>)
+        glProgramUniform1uiv(program, location, count, values.data());
+    else if constexpr (std::same_as<T, glm::mat3>)
+        glProgramUniformMatrix3fv(program, location, count, GL_FALSE, glm::value_ptr(values[0]));
+    else if constexpr (std::same_as<T, glm::mat4>)
+        glProgramUniformMatrix4fv(program, location, count, GL_FALSE, glm::value_ptr(values[0]));
+    else
+        static_assert(false, "not implemented");
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "gl/gl_state.hpp"
+#include "gl/std_layout.hpp"
+#include "gl/streaming_buffer.hpp"
+
+// A uniform block backed by a plain C++ struct, e.g.
+//
+//     struct Camera { glm::mat4 view; glm::mat4 projection; glm::vec3 position; GLfloat time; };
+//     layout(std140, binding = 0) uniform Camera { mat4 view; mat4 projection; vec3 position; float time; };
+//
+// The std140 padding is generated from T when uploading, the struct itself needs none. update() uploads the
+// whole block with a single glBufferSubData, and after bind() every program with a block at that binding
+// point sees it, so per-frame data is one upload instead of a glUniform call per value and program.
+// Shader::is_uniform_block_compatible<T>() checks a block against T.
+template<StdLayoutType T> class UniformBuffer
+{
+public:
+    static constexpr usize size = get_std_layout_info<StdLayout::std140, T>().size;
+
+    explicit inline UniformBuffer() noexcept
+    {
+        glGenBuffers(1, &_id);
+        gl_state().bind_buffer(GL_UNIFORM_BUFFER, _id);
+        glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    explicit inline UniformBuffer(const T& value) noexcept : UniformBuffer() { update(value); }
+
+    inline ~UniformBuffer() noexcept { gl_state().delete_buffer(_id); }
+
+    UniformBuffer(const UniformBuffer& other) = delete;
+    UniformBuffer(UniformBuffer&& other) = delete;
+
+    inline auto update(const T& value) noexcept -> void
+    {
+        write_std_layout<StdLayout::std140>(value, _staging);
+
+        gl_state().bind_buffer(GL_UNIFORM_BUFFER, _id);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), _staging.data());
+    }
+
+    inline auto bind(u32 binding) const noexcept -> void
+    {
+        gl_state().bind_buffer_base(GL_UNIFORM_BUFFER, binding, _id);
+    }
+
+    [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
+
+private:
+    GLuint _id;
+    std::array<std::byte, size> _staging{};
+};
+
+// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, needs a current context on first use
+[[nodiscard]] inline auto uniform_buffer_offset_alignment() noexcept -> usize
+{
+    static const usize alignment = [] {
+        GLint value = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+        return static_cast<usize>(value);
+    }();
+
+    return alignment;
+}
+
+// For blocks that change between draws: each value gets its own range of the streaming buffer, which is
+// persistently mapped where supported, so there's no glBufferSubData into a buffer a previous draw still
+// reads from. Returns false if the frame's region is full. The buffer has to be flushed before drawing.
+template<StdLayoutType T>
+[[nodiscard]] inline auto stream_uniform_block(StreamingBuffer& buffer, const T& value, u32 binding) noexcept
+    -> bool
+{
+    constexpr auto size = get_std_layout_info<StdLayout::std140, T>().size;
+    auto allocation = buffer.allocate(size, uniform_buffer_offset_alignment());
+
+    if (!allocation) [[unlikely]]
+        return false;
+
+    write_std_layout<StdLayout::std140>(value, allocation->memory);
+    gl_state().bind_buffer_range(GL_UNIFORM_BUFFER, binding, buffer.id(), allocation->offset,
+                                 static_cast<GLsizeiptr>(size));
+    return true;
+}
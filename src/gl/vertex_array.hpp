@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include "gl/gl_state.hpp"
+
 class VertexArray
 {
 public:
@@ -11,12 +13,12 @@ public:
         bind();
     }
 
-    inline ~VertexArray() noexcept { glDeleteVertexArrays(1, &_id); }
+    inline ~VertexArray() noexcept { gl_state().delete_vertex_array(_id); }
 
     VertexArray(const VertexArray& other) = delete;
     VertexArray(VertexArray&& other) = delete;
 
-    inline auto bind() const noexcept -> void { glBindVertexArray(_id); }
+    inline auto bind() const noexcept -> void { gl_state().bind_vertex_array(_id); }
     [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
 
 private:
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <typeindex>
+
+#include "gl/gl_state.hpp"
+#include "gl/vertex_array.hpp"
+#include "gl/vertex_buffer_layout.hpp"
+
+// One vertex array per vertex format instead of one per mesh. The format is declared once with
+// glVertexAttribFormat when a vertex type's vertex array is created; switching meshes then only attaches
+// their buffers, a glBindVertexBuffer and an element buffer bind, both skipped by GlState if unchanged.
+class VertexArrayCache
+{
+public:
+    static constexpr GLuint vertex_buffer_binding = 0;
+    static constexpr GLuint instance_buffer_binding = 1;
+
+    VertexArrayCache() = default;
+
+    VertexArrayCache(const VertexArrayCache& other) = delete;
+    VertexArrayCache(VertexArrayCache&& other) = delete;
+
+    // Binds the vertex array for VertexType, creating it on first use, and attaches the buffers. The vertex
+    // offset is in bytes.
+    template<typename VertexType>
+    auto bind(GLuint vertex_buffer, GLuint index_buffer, GLintptr vertex_offset = 0) -> void
+    {
+        get<VertexType, void>().bind();
+        gl_state().bind_vertex_buffer(vertex_buffer_binding, vertex_buffer, vertex_offset,
+                                      vertex_layout<VertexType>.stride);
+        gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    }
+
+    // like bind(), with InstanceType's attributes after VertexType's, advancing once per instance
+    template<typename VertexType, typename InstanceType>
+    auto bind_instanced(GLuint vertex_buffer, GLuint instance_buffer, GLuint index_buffer,
+                        GLintptr vertex_offset = 0, GLintptr instance_offset = 0) -> void
+    {
+        get<VertexType, InstanceType>().bind();
+        gl_state().bind_vertex_buffer(vertex_buffer_binding, vertex_buffer, vertex_offset,
+                                      vertex_layout<VertexType>.stride);
+        gl_state().bind_vertex_buffer(instance_buffer_binding, instance_buffer, instance_offset,
+                                      vertex_layout<InstanceType>.stride);
+        gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    }
+
+    [[nodiscard]] inline auto size() const noexcept -> usize { return _vertex_arrays.size(); }
+    inline auto clear() noexcept -> void { _vertex_arrays.clear(); }
+
+private:
+    template<typename VertexType, typename InstanceType> struct FormatKey
+    {
+    };
+
+    // InstanceType is void for vertex arrays without instance attributes
+    template<typename VertexType, typename InstanceType> auto get() -> const VertexArray&
+    {
+        auto& vertex_array = _vertex_arrays[std::type_index(typeid(FormatKey<VertexType, InstanceType>))];
+
+        if (!vertex_array) [[unlikely]]
+        {
+            // binds it
+            vertex_array = std::make_unique<VertexArray>();
+            set_vertex_format<VertexType>(vertex_buffer_binding);
+
+            if constexpr (!std::is_void_v<InstanceType>)
+            {
+                constexpr auto instance_location =
+                    static_cast<GLuint>(vertex_layout<VertexType>.attributes.size());
+                set_vertex_format<InstanceType>(instance_buffer_binding, instance_location, 1);
+            }
+        }
+
+        return *vertex_array;
+    }
+
+private:
+    std::unordered_map<std::type_index, std::unique_ptr<VertexArray>> _vertex_arrays{};
+};
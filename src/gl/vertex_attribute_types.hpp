@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/glm_concepts.hpp"
+
+// Compact vertex field types, which the shader still reads as floats. Convert float data to them with
+// quantize_attribute or quantize_vertices from gl/vertex_quantization.hpp.
+//
+// Plain integer fields (GLint, GLuint, glm::ivec2, glm::u8vec4, ...) are integer attributes instead, read
+// as int or uint vectors in GLSL without any conversion.
+
+template<typename T>
+concept NormalizableComponent =
+    std::same_as<T, i8> || std::same_as<T, u8> || std::same_as<T, i16> || std::same_as<T, u16>;
+
+template<typename T>
+concept NormalizableAttribute =
+    NormalizableComponent<T> || (GlmVector<T> && NormalizableComponent<typename T::value_type>);
+
+// n IEEE 754 half floats, GL_HALF_FLOAT
+template<usize n> struct HalfVec
+{
+    static_assert(n >= 1 && n <= 4);
+    std::array<u16, n> bits;
+};
+
+using Half = HalfVec<1>;
+using HalfVec2 = HalfVec<2>;
+using HalfVec3 = HalfVec<3>;
+using HalfVec4 = HalfVec<4>;
+
+// An 8 or 16-bit integer scalar or vector, mapped to [0, 1] for unsigned and [-1, 1] for signed components,
+// e.g. Normalized<glm::u8vec4> for a color in 4 instead of 16 bytes.
+template<NormalizableAttribute T> struct Normalized
+{
+    T value;
+};
+
+template<typename T> struct IsHalfVec : std::false_type
+{
+};
+
+template<usize n> struct IsHalfVec<HalfVec<n>> : std::true_type
+{
+};
+
+template<typename T> struct IsNormalized : std::false_type
+{
+};
+
+template<NormalizableAttribute T> struct IsNormalized<Normalized<T>> : std::true_type
+{
+};
+
+// x, y and z in 10 bits and w in 2, mapped to [-1, 1]; a normal or tangent in 4 instead of 12 bytes
+struct Snorm2_10_10_10
+{
+    u32 bits;
+};
+
+// x, y and z in 10 bits and w in 2, mapped to [0, 1]
+struct Unorm2_10_10_10
+{
+    u32 bits;
+};
@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include "gl/gl_state.hpp"
+
 class VertexBuffer
 {
 public:
@@ -33,7 +35,7 @@ public:
         buffer_data(data, usage);
     }
 
-    inline ~VertexBuffer() noexcept { glDeleteBuffers(1, &_id); }
+    inline ~VertexBuffer() noexcept { gl_state().delete_buffer(_id); }
 
     VertexBuffer(const VertexBuffer& other) = delete;
     VertexBuffer(VertexBuffer&& other) = delete;
@@ -58,7 +60,7 @@ public:
         glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.size_bytes()), data.data(), usage);
     }
 
-    inline auto bind() const noexcept -> void { glBindBuffer(GL_ARRAY_BUFFER, _id); }
+    inline auto bind() const noexcept -> void { gl_state().bind_buffer(GL_ARRAY_BUFFER, _id); }
     [[nodiscard]] inline auto id() const noexcept -> GLuint { return _id; }
 
 private:
@@ -1,33 +1,33 @@
 #pragma once
 
-template<usize n> struct Anything
-{
-    template<typename T> constexpr inline operator T() const { return T{}; };
-};
-
-template<typename T, usize... ints>
-concept ConstructibleFromNInitializers = requires { T{ Anything<ints>{}... }; };
+#include <glad/glad.h>
 
-template<typename T, usize n> static constexpr inline auto is_constructible_from_n_initializers() -> bool
-{
-    constexpr auto unpack = [&]<usize... ints>(std::index_sequence<ints...>) {
-        return ConstructibleFromNInitializers<T, ints...>;
-    };
+#include "core/struct_reflection.hpp"
+#include "gl/gl_state.hpp"
+#include "gl/vertex_attribute_types.hpp"
 
-    return unpack(std::make_index_sequence<n>{});
-}
+// Vertex attributes reflected from the fields of a vertex struct, at consecutive locations starting at 0 in
+// declaration order. A matrix field takes one location per column, every other field one. The whole table
+// is computed at compile time, binding it is a single loop over static data.
+//
+// Supported fields: GLfloat and float glm vectors and matrices, the types in gl/vertex_attribute_types.hpp,
+// and 8 to 32-bit integer scalars and glm vectors as integer attributes.
 
-template<typename T, usize n = 0u> static constexpr inline auto get_struct_arity() -> usize
+struct VertexAttribute
 {
-    constexpr auto constructible = is_constructible_from_n_initializers<T, n>();
+    GLuint location;
+    GLint count;
+    GLenum type;
+    GLboolean normalized;
+    bool integer; // read as int or uint in GLSL, set with glVertexAttribIPointer
+    usize offset;
+};
 
-    if constexpr (!constructible)
-        return n - 1;
-    else if constexpr (constructible)
-        return get_struct_arity<T, n + 1>();
-    else
-        return get_struct_arity<T, n + 1>();
-}
+template<usize attribute_count> struct VertexLayout
+{
+    GLsizei stride;
+    std::array<VertexAttribute, attribute_count> attributes;
+};
 
 namespace {
 
@@ -35,110 +35,250 @@ struct AttribSpecification
 {
     GLint count;
     GLenum type;
+    GLboolean normalized = GL_FALSE;
+    bool integer = false;
+    // matrices take a location per column, each column_size bytes after the previous one
+    GLuint locations = 1;
+    usize column_size = 0;
 };
 
-template<typename T> constexpr inline auto get_attrib_specification() -> AttribSpecification
-{
-    static_assert(false, "not implemented");
-}
-
-template<> constexpr inline auto get_attrib_specification<GLfloat>() -> AttribSpecification
+template<typename T> consteval inline auto get_attrib_component_type() -> GLenum
 {
-    return { 1, GL_FLOAT };
-}
-
-template<> constexpr inline auto get_attrib_specification<glm::vec2>() -> AttribSpecification
-{
-    static_assert(sizeof(glm::vec2) == sizeof(GLfloat) * 2);
-    return { 2, GL_FLOAT };
-}
-
-template<> constexpr inline auto get_attrib_specification<glm::vec3>() -> AttribSpecification
-{
-    static_assert(sizeof(glm::vec3) == sizeof(GLfloat) * 3);
-    return { 3, GL_FLOAT };
-}
-
-template<> constexpr inline auto get_attrib_specification<glm::vec4>() -> AttribSpecification
-{
-    static_assert(sizeof(glm::vec4) == sizeof(GLfloat) * 4);
-    return { 4, GL_FLOAT };
+    if constexpr (std::same_as<T, GLfloat>)
+        return GL_FLOAT;
+    else if constexpr (std::same_as<T, i8>)
+        return GL_BYTE;
+    else if constexpr (std::same_as<T, u8>)
+        return GL_UNSIGNED_BYTE;
+    else if constexpr (std::same_as<T, i16>)
+        return GL_SHORT;
+    else if constexpr (std::same_as<T, u16>)
+        return GL_UNSIGNED_SHORT;
+    else if constexpr (std::same_as<T, i32>)
+        return GL_INT;
+    else if constexpr (std::same_as<T, u32>)
+        return GL_UNSIGNED_INT;
+    else
+        static_assert(false, "not implemented");
 }
 
 template<typename T>
-inline auto bind_vertex_buffer_attrib(GLuint& location, GLsizei stride, GLsizei& offset) noexcept -> void
-{
-    constexpr auto spec = get_attrib_specification<T>();
-    glEnableVertexAttribArray(location);
-    glVertexAttribPointer(location, spec.count, spec.type, GL_FALSE, stride,
-                          reinterpret_cast<const void*>(static_cast<usize>(offset)));
+concept FloatVectorAttribute = GlmVector<T> && std::same_as<typename T::value_type, GLfloat>;
 
-    location++;
-    offset += sizeof(T);
-}
-
-} // namespace
+template<typename T>
+concept IntegerVectorAttribute = GlmVector<T> && std::integral<typename T::value_type>;
 
-template<typename VertexType> inline auto bind_vertex_buffer_layout() noexcept -> void
+template<typename T> consteval inline auto get_attrib_specification() -> AttribSpecification
 {
-    VertexType dummy{};
-    constexpr auto arity = get_struct_arity<VertexType>();
-
-    GLuint location = 0;
-    constexpr GLsizei stride = sizeof(VertexType);
-    GLsizei offset = 0;
-
-    if constexpr (arity == 0)
+    if constexpr (std::same_as<T, GLfloat>)
+    {
+        return { .count = 1, .type = GL_FLOAT };
+    }
+    else if constexpr (FloatVectorAttribute<T>)
     {
-        return;
+        static_assert(sizeof(T) == sizeof(GLfloat) * T::length());
+        return { .count = T::length(), .type = GL_FLOAT };
     }
-    else if constexpr (arity == 1)
+    else if constexpr (GlmMatrix<T>)
     {
-        [[maybe_unused]] auto& [f1] = dummy;
-        bind_vertex_buffer_attrib<decltype(f1)>(location, stride, offset);
+        static_assert(std::same_as<typename T::value_type, GLfloat>, "not implemented");
+        static_assert(sizeof(T) == sizeof(typename T::col_type) * T::length());
+
+        return {
+            .count = T::col_type::length(),
+            .type = GL_FLOAT,
+            .locations = static_cast<GLuint>(T::length()),
+            .column_size = sizeof(typename T::col_type),
+        };
     }
-    else if constexpr (arity == 2)
+    else if constexpr (IsHalfVec<T>::value)
     {
-        [[maybe_unused]] auto& [f1, f2] = dummy;
-        bind_vertex_buffer_attrib<decltype(f1)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f2)>(location, stride, offset);
+        return { .count = static_cast<GLint>(std::tuple_size_v<decltype(T::bits)>), .type = GL_HALF_FLOAT };
     }
-    else if constexpr (arity == 3)
+    else if constexpr (IsNormalized<T>::value)
     {
-        [[maybe_unused]] auto& [f1, f2, f3] = dummy;
-        bind_vertex_buffer_attrib<decltype(f1)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f2)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f3)>(location, stride, offset);
+        using Value = decltype(T::value);
+
+        if constexpr (GlmVector<Value>)
+        {
+            static_assert(sizeof(Value) == sizeof(typename Value::value_type) * Value::length());
+            return { .count = Value::length(),
+                     .type = get_attrib_component_type<typename Value::value_type>(),
+                     .normalized = GL_TRUE };
+        }
+        else
+        {
+            return { .count = 1, .type = get_attrib_component_type<Value>(), .normalized = GL_TRUE };
+        }
     }
-    else if constexpr (arity == 4)
+    else if constexpr (std::same_as<T, Snorm2_10_10_10>)
     {
-        [[maybe_unused]] auto& [f1, f2, f3, f4] = dummy;
-        bind_vertex_buffer_attrib<decltype(f1)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f2)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f3)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f4)>(location, stride, offset);
+        return { .count = 4, .type = GL_INT_2_10_10_10_REV, .normalized = GL_TRUE };
     }
-    else if constexpr (arity == 5)
+    else if constexpr (std::same_as<T, Unorm2_10_10_10>)
     {
-        [[maybe_unused]] auto& [f1, f2, f3, f4, f5] = dummy;
-        bind_vertex_buffer_attrib<decltype(f1)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f2)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f3)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f4)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f5)>(location, stride, offset);
+        return { .count = 4, .type = GL_UNSIGNED_INT_2_10_10_10_REV, .normalized = GL_TRUE };
     }
-    else if constexpr (arity == 6)
+    else if constexpr (IntegerVectorAttribute<T>)
     {
-        [[maybe_unused]] auto& [f1, f2, f3, f4, f5, f6] = dummy;
-        bind_vertex_buffer_attrib<decltype(f1)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f2)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f3)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f4)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f5)>(location, stride, offset);
-        bind_vertex_buffer_attrib<decltype(f6)>(location, stride, offset);
+        static_assert(sizeof(T) == sizeof(typename T::value_type) * T::length());
+        return { .count = T::length(),
+                 .type = get_attrib_component_type<typename T::value_type>(),
+                 .integer = true };
+    }
+    else if constexpr (std::integral<T>)
+    {
+        return { .count = 1, .type = get_attrib_component_type<T>(), .integer = true };
     }
     else
     {
         static_assert(false, "not implemented");
     }
 }
+
+[[nodiscard]] constexpr inline auto vertex_layout_align_up(usize value, usize alignment) noexcept -> usize
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Offsets of the fields, followed by the end of the last one. These are the offsets the compiler picks: each
+// field starts at the next multiple of its alignment, which the static_asserts on the vertex type make sure
+// is how it's laid out.
+template<typename VertexType> [[nodiscard]] constexpr inline auto get_vertex_field_offsets()
+{
+    using Fields = StructFieldTypes<VertexType>;
+    constexpr auto field_count = std::tuple_size_v<Fields>;
+
+    std::array<usize, field_count + 1> offsets{};
+    usize end = 0;
+
+    [&]<usize... indices>(std::index_sequence<indices...>) {
+        ((offsets[indices] = vertex_layout_align_up(end, alignof(std::tuple_element_t<indices, Fields>)),
+          end = offsets[indices] + sizeof(std::tuple_element_t<indices, Fields>)),
+         ...);
+    }(std::make_index_sequence<field_count>{});
+
+    offsets[field_count] = end;
+    return offsets;
+}
+
+template<typename VertexType> [[nodiscard]] consteval inline auto make_vertex_layout()
+{
+    static_assert(std::is_aggregate_v<VertexType> && std::is_standard_layout_v<VertexType>,
+                  "vertex types have to be plain structs");
+
+    using Fields = StructFieldTypes<VertexType>;
+    constexpr auto field_count = std::tuple_size_v<Fields>;
+    constexpr auto offsets = get_vertex_field_offsets<VertexType>();
+
+    // catches most layouts that differ from the natural one, e.g. through alignas on a field or packing
+    static_assert(vertex_layout_align_up(offsets[field_count], alignof(VertexType)) == sizeof(VertexType),
+                  "vertex type has a layout that can't be reflected");
+
+    constexpr auto attribute_count = [&]<usize... indices>(std::index_sequence<indices...>) {
+        return (usize{ 0 } + ...
+                + get_attrib_specification<std::tuple_element_t<indices, Fields>>().locations);
+    }(std::make_index_sequence<field_count>{});
+
+    VertexLayout<attribute_count> layout{ .stride = sizeof(VertexType), .attributes = {} };
+    GLuint location = 0;
+
+    auto add_field = [&]<usize index>() {
+        constexpr auto spec = get_attrib_specification<std::tuple_element_t<index, Fields>>();
+
+        for (GLuint column = 0; column < spec.locations; column++)
+        {
+            layout.attributes[location] = {
+                .location = location,
+                .count = spec.count,
+                .type = spec.type,
+                .normalized = spec.normalized,
+                .integer = spec.integer,
+                .offset = offsets[index] + column * spec.column_size,
+            };
+
+            location++;
+        }
+    };
+
+    [&]<usize... indices>(std::index_sequence<indices...>) {
+        (add_field.template operator()<indices>(), ...);
+    }(std::make_index_sequence<field_count>{});
+
+    return layout;
+}
+
+} // namespace
+
+template<typename VertexType> inline constexpr auto vertex_layout = make_vertex_layout<VertexType>();
+
+// first_location shifts every location, e.g. to put instance attributes after the vertex attributes. With
+// a divisor other than 0 the attributes advance once per that many instances instead of once per vertex.
+template<typename VertexType>
+inline auto bind_vertex_buffer_layout(GLuint first_location = 0, GLuint divisor = 0) noexcept -> void
+{
+    constexpr const auto& layout = vertex_layout<VertexType>;
+
+    for (const auto& attribute : layout.attributes)
+    {
+        auto location = first_location + attribute.location;
+        auto offset = reinterpret_cast<const void*>(attribute.offset);
+        glEnableVertexAttribArray(location);
+
+        if (attribute.integer)
+            glVertexAttribIPointer(location, attribute.count, attribute.type, layout.stride, offset);
+        else
+            glVertexAttribPointer(location, attribute.count, attribute.type, attribute.normalized,
+                                  layout.stride, offset);
+
+        if (divisor != 0)
+            glVertexAttribDivisor(location, divisor);
+    }
+}
+
+// Per-vertex attributes from vertex_buffer at the locations starting at 0, followed by per-instance
+// attributes from instance_buffer with a divisor of 1. The vertex array has to be bound.
+template<typename VertexType, typename InstanceType>
+inline auto bind_instanced_vertex_buffer_layout(GLuint vertex_buffer, GLuint instance_buffer) noexcept -> void
+{
+    constexpr auto instance_location = static_cast<GLuint>(vertex_layout<VertexType>.attributes.size());
+
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, vertex_buffer);
+    bind_vertex_buffer_layout<VertexType>();
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, instance_buffer);
+    bind_vertex_buffer_layout<InstanceType>(instance_location, 1);
+}
+
+// Declares the format of VertexType's attributes for the bound vertex array once, reading from the buffer
+// binding point binding_index. Buffers are then attached with a single glBindVertexBuffer, see
+// GlState::bind_vertex_buffer, without specifying the attributes again. first_location and divisor work as
+// for bind_vertex_buffer_layout.
+template<typename VertexType>
+inline auto set_vertex_format(GLuint binding_index, GLuint first_location = 0, GLuint divisor = 0) noexcept
+    -> void
+{
+    constexpr const auto& layout = vertex_layout<VertexType>;
+
+    // the minimum of GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET
+    static_assert(std::ranges::all_of(layout.attributes, [](const auto& attribute) {
+                      return attribute.offset <= 2047;
+                  }),
+                  "vertex type is too large for relative attribute offsets");
+
+    for (const auto& attribute : layout.attributes)
+    {
+        auto location = first_location + attribute.location;
+        auto offset = static_cast<GLuint>(attribute.offset);
+        glEnableVertexAttribArray(location);
+
+        if (attribute.integer)
+            glVertexAttribIFormat(location, attribute.count, attribute.type, offset);
+        else
+            glVertexAttribFormat(location, attribute.count, attribute.type, attribute.normalized, offset);
+
+        glVertexAttribBinding(location, binding_index);
+    }
+
+    if (divisor != 0)
+        glVertexBindingDivisor(binding_index, divisor);
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+#include <limits>
+
+#include "core/struct_reflection.hpp"
+#include "gl/vertex_attribute_types.hpp"
+
+// Conversion of float vertex data to the compact types in gl/vertex_attribute_types.hpp, e.g. once when a
+// mesh is loaded. The shader reads the converted attributes as the same floats, up to the precision lost.
+
+template<NormalizableComponent T>
+[[nodiscard]] inline auto quantize_normalized_component(f32 value) noexcept -> T
+{
+    constexpr auto max = static_cast<f32>(std::numeric_limits<T>::max());
+
+    // GL maps signed values symmetrically, the most negative integer reads as -1 just like the one above it
+    auto clamped = std::is_signed_v<T> ? std::clamp(value, -1.0f, 1.0f) : std::clamp(value, 0.0f, 1.0f);
+    return static_cast<T>(std::round(clamped * max));
+}
+
+// Converts a float scalar or vector to the vertex field type Out, which has as many components. Fields of the
+// same type are copied, so integer or already compact fields pass through.
+template<typename Out, typename In>
+[[nodiscard]] inline auto quantize_attribute(const In& value) noexcept -> Out
+{
+    constexpr auto is_float_vector = [] {
+        if constexpr (GlmVector<In>)
+            return std::same_as<typename In::value_type, f32>;
+        else
+            return false;
+    }();
+
+    constexpr auto component_count = [] {
+        if constexpr (GlmVector<In>)
+            return static_cast<usize>(In::length());
+        else
+            return usize{ 1 };
+    }();
+
+    static_assert(std::same_as<Out, In> || std::same_as<In, f32> || is_float_vector, "not implemented");
+
+    [[maybe_unused]] auto component = [&](usize index) -> f32 {
+        if constexpr (GlmVector<In>)
+            return static_cast<f32>(value[static_cast<glm::length_t>(index)]);
+        else
+            return static_cast<f32>(value);
+    };
+
+    if constexpr (std::same_as<Out, In>)
+    {
+        return value;
+    }
+    else if constexpr (IsHalfVec<Out>::value)
+    {
+        Out half{};
+        static_assert(std::tuple_size_v<decltype(Out::bits)> == component_count);
+
+        for (usize i = 0; i < half.bits.size(); i++)
+            half.bits[i] = glm::packHalf1x16(component(i));
+
+        return half;
+    }
+    else if constexpr (IsNormalized<Out>::value)
+    {
+        using Value = decltype(Out::value);
+        Out normalized{};
+
+        if constexpr (GlmVector<Value>)
+        {
+            using Component = typename Value::value_type;
+            static_assert(static_cast<usize>(Value::length()) == component_count);
+
+            for (glm::length_t i = 0; i < Value::length(); i++)
+            {
+                auto index = static_cast<usize>(i);
+                normalized.value[i] = quantize_normalized_component<Component>(component(index));
+            }
+        }
+        else
+        {
+            static_assert(component_count == 1);
+            normalized.value = quantize_normalized_component<Value>(value);
+        }
+
+        return normalized;
+    }
+    else if constexpr (std::same_as<Out, Snorm2_10_10_10> || std::same_as<Out, Unorm2_10_10_10>)
+    {
+        static_assert(component_count == 3 || component_count == 4);
+
+        // a vec3 gets w = 0, as for a normal
+        auto w = component_count == 4 ? component(3) : 0.0f;
+        auto vector = glm::vec4{ component(0), component(1), component(2), w };
+
+        if constexpr (std::same_as<Out, Snorm2_10_10_10>)
+            return Out{ glm::packSnorm3x10_1x2(vector) };
+        else
+            return Out{ glm::packUnorm3x10_1x2(vector) };
+    }
+    else
+    {
+        static_assert(false, "not implemented");
+    }
+}
+
+// Converts each field of the vertices to the type of the field at the same position in QuantizedVertex,
+// with quantize_attribute. Both types need the same number of fields.
+template<typename QuantizedVertex, typename Vertex>
+[[nodiscard]] inline auto quantize_vertices(std::span<const Vertex> vertices) -> std::vector<QuantizedVertex>
+{
+    using Fields = StructFieldTypes<QuantizedVertex>;
+    constexpr auto field_count = std::tuple_size_v<Fields>;
+    static_assert(field_count == std::tuple_size_v<StructFieldTypes<Vertex>>, "vertex types don't match");
+
+    std::vector<QuantizedVertex> quantized(vertices.size());
+
+    for (usize i = 0; i < vertices.size(); i++)
+    {
+        auto fields = tie_struct_fields(vertices[i]);
+        auto quantized_fields = tie_struct_fields(quantized[i]);
+
+        [&]<usize... indices>(std::index_sequence<indices...>) {
+            ((std::get<indices>(quantized_fields) =
+                  quantize_attribute<std::tuple_element_t<indices, Fields>>(std::get<indices>(fields))),
+             ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+
+    return quantized;
+}
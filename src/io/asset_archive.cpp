@@ -0,0 +1,265 @@
+#include "asset_archive.hpp"
+
+#include <bit>
+#include <fstream>
+
+#include "core/hash.hpp"
+
+static_assert(std::endian::native == std::endian::little, "asset archives are stored little-endian");
+static_assert(sizeof(AssetArchiveHeader) == 16);
+static_assert(sizeof(AssetArchiveEntry) == 40);
+
+static constexpr u32 empty_slot = 0;
+
+[[nodiscard]] static inline auto align_up(usize value, usize alignment) noexcept -> usize
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+AssetArchive::AssetArchive(const std::filesystem::path& path) : _path(path), _file(path)
+{
+    auto bytes = _file.bytes();
+
+    auto invalid = [&](std::string_view reason) {
+        return InvalidAssetArchive{ std::format("Invalid asset archive {}: {}", path.string(), reason) };
+    };
+
+    if (bytes.size() < sizeof(AssetArchiveHeader)) [[unlikely]]
+        throw invalid("file too small");
+
+    auto header = reinterpret_cast<const AssetArchiveHeader*>(bytes.data());
+
+    if (header->magic != asset_archive_magic) [[unlikely]]
+        throw invalid("bad magic");
+
+    if (header->version != asset_archive_version) [[unlikely]]
+        throw invalid(std::format("unsupported version {}", header->version));
+
+    if (!std::has_single_bit(header->slot_count) || header->slot_count <= header->entry_count) [[unlikely]]
+        throw invalid("bad hash table size");
+
+    usize slots_offset = sizeof(AssetArchiveHeader);
+    usize entries_offset = slots_offset + header->slot_count * sizeof(u32);
+    usize names_offset = entries_offset + header->entry_count * sizeof(AssetArchiveEntry);
+
+    if (names_offset > bytes.size()) [[unlikely]]
+        throw invalid("truncated table of contents");
+
+    _slots = { reinterpret_cast<const u32*>(bytes.data() + slots_offset), header->slot_count };
+    _entries = { reinterpret_cast<const AssetArchiveEntry*>(bytes.data() + entries_offset),
+                 header->entry_count };
+
+    // validate once here, so lookups can trust the table of contents
+    for (const auto& entry : _entries)
+    {
+        if (entry.name_offset > bytes.size() || entry.name_size > bytes.size() - entry.name_offset
+            || entry.data_offset > bytes.size() || entry.data_size > bytes.size() - entry.data_offset)
+            [[unlikely]]
+            throw invalid("entry out of bounds");
+    }
+
+    usize empty_slots = 0;
+
+    for (u32 slot : _slots)
+    {
+        if (slot > _entries.size()) [[unlikely]]
+            throw invalid("hash table entry out of bounds");
+
+        if (slot == empty_slot)
+            empty_slots++;
+    }
+
+    // lookups of missing names stop at the first empty slot
+    if (empty_slots == 0) [[unlikely]]
+        throw invalid("hash table has no empty slot");
+}
+
+auto AssetArchive::find(const std::filesystem::path& name) const noexcept
+    -> std::optional<std::span<const std::byte>>
+{
+    std::string normalized_name;
+
+    try
+    {
+        normalized_name = normalize_name(name);
+    }
+    catch (...)
+    {
+        return std::nullopt;
+    }
+
+    auto hash = fnv1a_64(normalized_name);
+    auto mask = _slots.size() - 1;
+    auto bytes = _file.bytes();
+
+    // bounded as well, in case the mapped file changes under us
+    for (usize probe = 0, slot_index = hash & mask; probe < _slots.size();
+         probe++, slot_index = (slot_index + 1) & mask)
+    {
+        u32 slot = _slots[slot_index];
+
+        if (slot == empty_slot)
+            return std::nullopt;
+
+        const auto& entry = _entries[slot - 1];
+
+        if (entry.name_hash != hash)
+            continue;
+
+        std::string_view entry_name{ reinterpret_cast<const char*>(bytes.data() + entry.name_offset),
+                                     entry.name_size };
+
+        if (entry_name == normalized_name) [[likely]]
+            return bytes.subspan(entry.data_offset, entry.data_size);
+    }
+
+    return std::nullopt;
+}
+
+auto AssetArchive::read(const std::filesystem::path& name) const -> std::span<const std::byte>
+{
+    auto data = find(name);
+
+    if (!data) [[unlikely]]
+    {
+        auto message = std::format("Invalid file path: {} (in archive {})", name.string(), _path.string());
+        throw InvalidFilePath{ message };
+    }
+
+    return *data;
+}
+
+auto AssetArchive::normalize_name(const std::filesystem::path& name) -> std::string
+{
+    return name.lexically_normal().generic_string();
+}
+
+auto AssetArchiveWriter::add_file(const std::filesystem::path& name, const std::filesystem::path& file_path)
+    -> void
+{
+    MappedFile file(file_path);
+    add(name, file.bytes());
+}
+
+auto AssetArchiveWriter::add(const std::filesystem::path& name, std::span<const std::byte> data) -> void
+{
+    _entries.push_back({
+        .name = AssetArchive::normalize_name(name),
+        .data = { data.begin(), data.end() },
+    });
+}
+
+auto AssetArchiveWriter::write(const std::filesystem::path& archive_path) const -> void
+{
+    std::vector<const PendingEntry*> sorted_entries;
+    sorted_entries.reserve(_entries.size());
+
+    for (const auto& entry : _entries)
+        sorted_entries.push_back(&entry);
+
+    // sorted, so that the same set of assets always produces the same archive
+    std::ranges::sort(sorted_entries, {}, &PendingEntry::name);
+
+    auto duplicate = std::ranges::adjacent_find(sorted_entries, {}, &PendingEntry::name);
+
+    if (duplicate != sorted_entries.end()) [[unlikely]]
+        throw InvalidAssetArchive{ std::format("Duplicate asset archive entry: {}", (*duplicate)->name) };
+
+    // keep the load factor at or below 0.5, so probe sequences stay short
+    auto entry_count = static_cast<u32>(sorted_entries.size());
+    auto slot_count = std::bit_ceil(std::max(entry_count * 2, 2u));
+
+    AssetArchiveHeader header = {
+        .magic = asset_archive_magic,
+        .version = asset_archive_version,
+        .entry_count = entry_count,
+        .slot_count = slot_count,
+    };
+
+    std::vector<u32> slots(slot_count, empty_slot);
+    std::vector<AssetArchiveEntry> entries(entry_count);
+
+    usize names_offset = sizeof(AssetArchiveHeader) + slot_count * sizeof(u32)
+                         + entry_count * sizeof(AssetArchiveEntry);
+    usize names_size = 0;
+
+    for (const auto* entry : sorted_entries)
+        names_size += entry->name.size();
+
+    usize name_offset = names_offset;
+    usize data_offset = align_up(names_offset + names_size, asset_archive_data_alignment);
+
+    for (u32 i = 0; i < entry_count; i++)
+    {
+        const auto& pending = *sorted_entries[i];
+        auto hash = fnv1a_64(pending.name);
+
+        entries[i] = {
+            .name_hash = hash,
+            .name_offset = name_offset,
+            .data_offset = data_offset,
+            .data_size = pending.data.size(),
+            .name_size = static_cast<u32>(pending.name.size()),
+            .reserved = 0,
+        };
+
+        name_offset += pending.name.size();
+        data_offset = align_up(data_offset + pending.data.size(), asset_archive_data_alignment);
+
+        usize slot_index = hash & (slot_count - 1);
+
+        while (slots[slot_index] != empty_slot)
+            slot_index = (slot_index + 1) & (slot_count - 1);
+
+        slots[slot_index] = i + 1;
+    }
+
+    std::ofstream file(archive_path, std::ios::binary | std::ios::trunc);
+
+    if (!file) [[unlikely]]
+        throw FailedToOpenFile{ std::format("Can't open file: {}", archive_path.string()) };
+
+    auto write_bytes = [&](const void* data, usize size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+
+    auto pad_to = [&](usize offset) {
+        static constexpr std::array<char, asset_archive_data_alignment> zeros{};
+        auto position = static_cast<usize>(file.tellp());
+        write_bytes(zeros.data(), offset - position);
+    };
+
+    write_bytes(&header, sizeof(header));
+    write_bytes(slots.data(), slots.size() * sizeof(u32));
+    write_bytes(entries.data(), entries.size() * sizeof(AssetArchiveEntry));
+
+    for (const auto* entry : sorted_entries)
+        write_bytes(entry->name.data(), entry->name.size());
+
+    for (u32 i = 0; i < entry_count; i++)
+    {
+        pad_to(entries[i].data_offset);
+        write_bytes(sorted_entries[i]->data.data(), sorted_entries[i]->data.size());
+    }
+
+    if (!file.good()) [[unlikely]]
+        throw FailedToWriteToFile{ std::format("Can't write to file: {}", archive_path.string()) };
+}
+
+auto read_from_file(const AssetArchive& archive, const std::filesystem::path& name) -> std::stringstream
+{
+    auto data = archive.read(name);
+
+    std::stringstream stream;
+    stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    stream << '\0';
+
+    if (!stream.good()) [[unlikely]]
+    {
+        auto message = std::format("Can't read from file: {} (in archive {})", name.string(),
+                                   archive.path().string());
+        throw FailedToReadFromFile{ message };
+    }
+
+    return stream;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <filesystem>
+
+#include "io/file_io.hpp"
+#include "io/mapped_file.hpp"
+
+// Single-file asset archive (.pak). Layout, all integers little-endian:
+//
+//   AssetArchiveHeader
+//   u32 slots[slot_count]             open-addressing hash table, entry index + 1 (0 = empty slot)
+//   AssetArchiveEntry entries[entry_count]
+//   char names[]                      entry names, not null-terminated
+//   data                              entry contents, each aligned to asset_archive_data_alignment
+//
+// Names are normalized generic paths (e.g. "shaders/basic.vert") hashed with fnv1a_64, so looking an
+// asset up is a hash, a probe or two and a single string compare, all on the mapped memory.
+
+static constexpr u32 asset_archive_magic = 0x4b504c47; // "GLPK"
+static constexpr u32 asset_archive_version = 1;
+static constexpr usize asset_archive_data_alignment = 16;
+
+struct AssetArchiveHeader
+{
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 slot_count; // power of two
+};
+
+struct AssetArchiveEntry
+{
+    u64 name_hash;
+    u64 name_offset;
+    u64 data_offset;
+    u64 data_size;
+    u32 name_size;
+    u32 reserved;
+};
+
+class AssetArchive
+{
+public:
+    // throws FileIoError
+    explicit AssetArchive(const std::filesystem::path& path);
+
+    AssetArchive(const AssetArchive& other) = delete;
+    AssetArchive(AssetArchive&& other) = default;
+
+    [[nodiscard]] auto find(const std::filesystem::path& name) const noexcept
+        -> std::optional<std::span<const std::byte>>;
+
+    // throws InvalidFilePath
+    [[nodiscard]] auto read(const std::filesystem::path& name) const -> std::span<const std::byte>;
+
+    [[nodiscard]] inline auto contains(const std::filesystem::path& name) const noexcept -> bool
+    {
+        return find(name).has_value();
+    }
+
+    [[nodiscard]] inline auto entry_count() const noexcept -> usize { return _entries.size(); }
+    [[nodiscard]] inline auto path() const noexcept -> const std::filesystem::path& { return _path; }
+
+    [[nodiscard]] static auto normalize_name(const std::filesystem::path& name) -> std::string;
+
+private:
+    std::filesystem::path _path;
+    MappedFile _file;
+    std::span<const u32> _slots{};
+    std::span<const AssetArchiveEntry> _entries{};
+};
+
+class AssetArchiveWriter
+{
+public:
+    // throws FileIoError
+    auto add_file(const std::filesystem::path& name, const std::filesystem::path& file_path) -> void;
+    auto add(const std::filesystem::path& name, std::span<const std::byte> data) -> void;
+
+    // throws FileIoError
+    auto write(const std::filesystem::path& archive_path) const -> void;
+
+private:
+    struct PendingEntry
+    {
+        std::string name;
+        std::vector<std::byte> data;
+    };
+
+    std::vector<PendingEntry> _entries{};
+};
+
+class InvalidAssetArchive : public FileIoError
+{
+public:
+    inline InvalidAssetArchive(const char* message) noexcept : FileIoError(message) {}
+    inline InvalidAssetArchive(const std::string& message) noexcept : FileIoError(message) {}
+};
+
+// throws FileIoError
+[[nodiscard]] auto read_from_file(const AssetArchive& archive, const std::filesystem::path& name)
+    -> std::stringstream;
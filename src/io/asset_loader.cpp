@@ -0,0 +1,211 @@
+#include "asset_loader.hpp"
+
+#include "core/log.hpp"
+#include "io/image.hpp"
+#include "io/mapped_file.hpp"
+
+AssetLoader::AssetLoader(usize worker_count, const ProgramBinaryCache* program_binary_cache)
+    : _program_binary_cache(program_binary_cache), _workers(worker_count)
+{
+}
+
+auto AssetLoader::load_shader(const std::filesystem::path& vertex_src_path,
+                              const std::filesystem::path& fragment_src_path) -> AssetFuture<Shader>
+{
+    std::promise<std::unique_ptr<Shader>> promise;
+    auto future = promise.get_future();
+    _pending_count++;
+
+    _workers.submit([this, vertex_src_path, fragment_src_path, promise = std::move(promise)]() mutable {
+        std::optional<MappedFile> vertex_src;
+        std::optional<MappedFile> fragment_src;
+
+        try
+        {
+            vertex_src.emplace(vertex_src_path);
+            fragment_src.emplace(fragment_src_path);
+        }
+        catch (FileIoError& e)
+        {
+            auto shader_type = vertex_src ? "fragment" : "vertex";
+            auto message = std::format("Can't read {} shader source file: {}", shader_type, e.what());
+            log_error("{}", message);
+
+            promise.set_exception(std::make_exception_ptr(CreateShaderError{ message }));
+            _pending_count--;
+            return;
+        }
+        catch (...)
+        {
+            // e.g. std::bad_alloc, still reported through the future so the loader doesn't stay busy
+            promise.set_exception(std::current_exception());
+            _pending_count--;
+            return;
+        }
+
+        queue_gl_stage([this, vertex_src = std::move(*vertex_src), fragment_src = std::move(*fragment_src),
+                        vertex_name = vertex_src_path.string(), fragment_name = fragment_src_path.string(),
+                        promise = std::move(promise)]() mutable {
+            auto sources = ShaderSources{
+                .vertex = vertex_src.view(),
+                .fragment = fragment_src.view(),
+                .vertex_name = vertex_name,
+                .fragment_name = fragment_name,
+            };
+
+            ShaderBuildHandle handle;
+
+            try
+            {
+                if (!_shader_batch)
+                    _shader_batch.emplace(_program_binary_cache);
+
+                handle = _shader_batch->submit(sources);
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+                _pending_count--;
+                return;
+            }
+
+            // finished in collect_shaders()
+            _pending_shaders.push_back({ .handle = handle, .promise = std::move(promise) });
+        });
+    });
+
+    return future;
+}
+
+auto AssetLoader::load_texture(const std::filesystem::path& path, bool generate_mipmap,
+                               std::optional<Texture2DOptions> options) -> AssetFuture<Texture2D>
+{
+    std::promise<std::unique_ptr<Texture2D>> promise;
+    auto future = promise.get_future();
+    _pending_count++;
+
+    _workers.submit([this, path, generate_mipmap, options, promise = std::move(promise)]() mutable {
+        std::optional<Image> image;
+
+        try
+        {
+            MappedFile file(path);
+            image.emplace(file.bytes());
+        }
+        catch (std::runtime_error& e)
+        {
+            // FileIoError or DecodeImageError
+            auto message = std::format("Can't create texture: {}: {}", path.string(), e.what());
+            log_error("{}", message);
+
+            promise.set_exception(std::make_exception_ptr(CreateTextureError{ message }));
+            _pending_count--;
+            return;
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+            _pending_count--;
+            return;
+        }
+
+        queue_gl_stage([this, image = std::move(*image), generate_mipmap, options,
+                        promise = std::move(promise)]() mutable {
+            try
+            {
+                if (!_texture_uploader)
+                    _texture_uploader.emplace();
+
+                // pixels are streamed through the uploader's PBOs, so the GL stage doesn't wait on the copy
+                auto options_ptr = options ? &*options : nullptr;
+                auto mip_levels =
+                    generate_mipmap ? Texture2D::mip_level_count(image.width(), image.height()) : 1;
+                auto texture = std::make_unique<Texture2D>(image.width(), image.height(), image.channels(),
+                                                           mip_levels, options_ptr);
+
+                _texture_uploader->upload(*texture, image, generate_mipmap);
+                promise.set_value(std::move(texture));
+            }
+            catch (TextureUploadError& e)
+            {
+                auto message = std::format("Can't create texture: {}", e.what());
+                log_error("{}", message);
+                promise.set_exception(std::make_exception_ptr(CreateTextureError{ message }));
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+            }
+
+            _pending_count--;
+        });
+    });
+
+    return future;
+}
+
+auto AssetLoader::update(std::chrono::microseconds time_budget) -> usize
+{
+    auto start = std::chrono::steady_clock::now();
+    usize completed = collect_shaders();
+
+    while (true)
+    {
+        std::move_only_function<void()> stage;
+
+        {
+            std::scoped_lock lock(_gl_stages_mutex);
+
+            if (_gl_stages.empty())
+                break;
+
+            stage = std::move(_gl_stages.front());
+            _gl_stages.pop_front();
+        }
+
+        stage();
+        completed++;
+
+        if (std::chrono::steady_clock::now() - start >= time_budget)
+            break;
+    }
+
+    return completed;
+}
+
+auto AssetLoader::collect_shaders() -> usize
+{
+    if (_pending_shaders.empty())
+        return 0;
+
+    // builds served from the binary cache are finished right away, so the partition can't be skipped even
+    // if poll() finished nothing new
+    _shader_batch->poll();
+
+    auto finished = std::ranges::partition(_pending_shaders, [this](const PendingShader& pending) {
+        return !_shader_batch->is_finished(pending.handle);
+    });
+
+    for (auto& pending : finished)
+    {
+        auto result = _shader_batch->take(pending.handle);
+
+        if (result)
+            pending.promise.set_value(std::move(*result));
+        else
+            pending.promise.set_exception(std::make_exception_ptr(result.error()));
+
+        _pending_count--;
+    }
+
+    auto finished_count = finished.size();
+    _pending_shaders.erase(finished.begin(), finished.end());
+
+    return finished_count;
+}
+
+auto AssetLoader::queue_gl_stage(std::move_only_function<void()> stage) -> void
+{
+    std::scoped_lock lock(_gl_stages_mutex);
+    _gl_stages.push_back(std::move(stage));
+}
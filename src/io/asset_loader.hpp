@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+
+#include "core/thread_pool.hpp"
+#include "gl/shader.hpp"
+#include "gl/shader_batch.hpp"
+#include "gl/texture.hpp"
+#include "gl/texture_uploader.hpp"
+
+// Loads assets without blocking the render loop. Reading files and decoding images happens on worker
+// threads; only the final GL calls run on the context thread, inside update(), which is meant to be called
+// once per frame with a time budget.
+class AssetLoader
+{
+public:
+    template<typename T> using AssetFuture = std::future<std::unique_ptr<T>>;
+
+    // 0 means one worker per hardware thread; shaders go through the binary cache if there is one
+    explicit AssetLoader(usize worker_count = 0, const ProgramBinaryCache* program_binary_cache = nullptr);
+
+    AssetLoader(const AssetLoader& other) = delete;
+    AssetLoader(AssetLoader&& other) = delete;
+
+    // the future holds CreateShaderError if loading fails
+    [[nodiscard]] auto load_shader(const std::filesystem::path& vertex_src_path,
+                                   const std::filesystem::path& fragment_src_path) -> AssetFuture<Shader>;
+
+    // the future holds CreateTextureError if loading fails
+    [[nodiscard]] auto load_texture(const std::filesystem::path& path, bool generate_mipmap = true,
+                                    std::optional<Texture2DOptions> options = std::nullopt)
+        -> AssetFuture<Texture2D>;
+
+    // call on the context thread; collects finished shader builds, then runs queued GL stages until
+    // time_budget is used up, but always at least one, so loading makes progress even with a tiny budget
+    // returns the number of steps completed
+    auto update(std::chrono::microseconds time_budget) -> usize;
+
+    [[nodiscard]] inline auto pending_count() const noexcept -> usize
+    {
+        return _pending_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct PendingShader
+    {
+        ShaderBuildHandle handle;
+        std::promise<std::unique_ptr<Shader>> promise;
+    };
+
+    auto queue_gl_stage(std::move_only_function<void()> stage) -> void;
+    auto collect_shaders() -> usize;
+
+private:
+    std::mutex _gl_stages_mutex;
+    std::deque<std::move_only_function<void()>> _gl_stages{};
+    std::atomic<usize> _pending_count = 0;
+    const ProgramBinaryCache* _program_binary_cache;
+
+    // created on first use, on the context thread; shaders are compiled in one batch, so the driver can
+    // work on all of them at once instead of one per GL stage
+    std::optional<TextureUploader> _texture_uploader{};
+    std::optional<ShaderBatch> _shader_batch{};
+    std::vector<PendingShader> _pending_shaders{};
+
+    // declared last, so the workers are joined before the queue they push to is destroyed
+    ThreadPool _workers;
+};
+
+template<typename T> [[nodiscard]] inline auto is_ready(const std::future<T>& future) -> bool
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
@@ -0,0 +1,474 @@
+#include "batch_file_reader.hpp"
+
+#include <atomic>
+#include <fstream>
+
+#include "core/log.hpp"
+#include "core/thread_pool.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define HAS_IO_URING
+
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAS_IO_URING
+
+// Minimal io_uring wrapper talking to the kernel directly, so there's no dependency on liburing.
+struct BatchFileReader::IoUring
+{
+    int fd = -1;
+
+    void* sq_ring = MAP_FAILED;
+    usize sq_ring_size = 0;
+    void* cq_ring = MAP_FAILED;
+    usize cq_ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    usize sqes_size = 0;
+
+    u32* sq_head = nullptr;
+    u32* sq_tail = nullptr;
+    u32* sq_mask = nullptr;
+    u32* sq_array = nullptr;
+    u32 sq_entries = 0;
+
+    u32* cq_head = nullptr;
+    u32* cq_tail = nullptr;
+    u32* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    u32 cq_entries = 0;
+
+    u32 pending_submissions = 0;
+
+    // returns nullptr if io_uring can't be used
+    [[nodiscard]] static auto create(u32 queue_depth) noexcept -> std::unique_ptr<IoUring>;
+    ~IoUring() noexcept;
+
+    [[nodiscard]] auto get_sqe() noexcept -> io_uring_sqe*;
+    // returns the number of submitted entries or -errno, interrupted waits are retried
+    [[nodiscard]] auto submit_and_wait(u32 wait_count) noexcept -> int;
+
+    template<typename Func> auto consume_completions(Func&& func) -> void
+    {
+        u32 head = *cq_head;
+        u32 tail = std::atomic_ref(*cq_tail).load(std::memory_order_acquire);
+
+        for (; head != tail; head++)
+            func(cqes[head & *cq_mask]);
+
+        std::atomic_ref(*cq_head).store(head, std::memory_order_release);
+    }
+};
+
+auto BatchFileReader::IoUring::create(u32 queue_depth) noexcept -> std::unique_ptr<IoUring>
+{
+    io_uring_params params{};
+    int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+
+    if (ring_fd < 0)
+        return nullptr;
+
+    auto ring = std::make_unique<IoUring>();
+    ring->fd = ring_fd;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+
+    if (single_mmap)
+        ring->sq_ring_size = ring->cq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+
+    ring->sq_ring = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring_fd, IORING_OFF_SQ_RING);
+
+    if (ring->sq_ring == MAP_FAILED)
+        return nullptr;
+
+    if (single_mmap)
+    {
+        ring->cq_ring = ring->sq_ring;
+    }
+    else
+    {
+        ring->cq_ring = mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             ring_fd, IORING_OFF_CQ_RING);
+
+        if (ring->cq_ring == MAP_FAILED)
+            return nullptr;
+    }
+
+    auto sqes = mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                     IORING_OFF_SQES);
+
+    if (sqes == MAP_FAILED)
+        return nullptr;
+
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto sq_field = [&](u32 offset) {
+        return reinterpret_cast<u32*>(static_cast<u8*>(ring->sq_ring) + offset);
+    };
+    auto cq_field = [&](u32 offset) { return static_cast<u8*>(ring->cq_ring) + offset; };
+
+    ring->sq_head = sq_field(params.sq_off.head);
+    ring->sq_tail = sq_field(params.sq_off.tail);
+    ring->sq_mask = sq_field(params.sq_off.ring_mask);
+    ring->sq_array = sq_field(params.sq_off.array);
+    ring->sq_entries = params.sq_entries;
+
+    ring->cq_head = reinterpret_cast<u32*>(cq_field(params.cq_off.head));
+    ring->cq_tail = reinterpret_cast<u32*>(cq_field(params.cq_off.tail));
+    ring->cq_mask = reinterpret_cast<u32*>(cq_field(params.cq_off.ring_mask));
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq_field(params.cq_off.cqes));
+    ring->cq_entries = params.cq_entries;
+
+    return ring;
+}
+
+BatchFileReader::IoUring::~IoUring() noexcept
+{
+    if (sqes)
+        munmap(sqes, sqes_size);
+
+    if (cq_ring != MAP_FAILED && cq_ring != sq_ring)
+        munmap(cq_ring, cq_ring_size);
+
+    if (sq_ring != MAP_FAILED)
+        munmap(sq_ring, sq_ring_size);
+
+    if (fd >= 0)
+        close(fd);
+}
+
+auto BatchFileReader::IoUring::get_sqe() noexcept -> io_uring_sqe*
+{
+    u32 head = std::atomic_ref(*sq_head).load(std::memory_order_acquire);
+    u32 tail = *sq_tail;
+
+    if (tail - head >= sq_entries)
+        return nullptr;
+
+    u32 index = tail & *sq_mask;
+    sq_array[index] = index;
+    std::atomic_ref(*sq_tail).store(tail + 1, std::memory_order_release);
+    pending_submissions++;
+
+    auto sqe = &sqes[index];
+    *sqe = {};
+    return sqe;
+}
+
+auto BatchFileReader::IoUring::submit_and_wait(u32 wait_count) noexcept -> int
+{
+    int result;
+
+    do
+    {
+        result = static_cast<int>(syscall(__NR_io_uring_enter, fd, pending_submissions, wait_count,
+                                          IORING_ENTER_GETEVENTS, nullptr, 0));
+    } while (result < 0 && errno == EINTR);
+
+    if (result < 0)
+        return -errno;
+
+    pending_submissions -= static_cast<u32>(result);
+    return result;
+}
+
+#else
+
+struct BatchFileReader::IoUring
+{
+};
+
+#endif
+
+BatchFileReader::BatchFileReader([[maybe_unused]] u32 queue_depth, ThreadPool* fallback_pool)
+    : _fallback_pool(fallback_pool)
+{
+#ifdef HAS_IO_URING
+    _ring = IoUring::create(queue_depth);
+#endif
+}
+
+BatchFileReader::~BatchFileReader() noexcept = default;
+
+auto BatchFileReader::read(std::span<BatchReadRequest> requests) -> void
+{
+    if (!_ring)
+    {
+        read_with_thread_pool(requests);
+        return;
+    }
+
+#ifdef HAS_IO_URING
+    struct FileState
+    {
+        int fd = -1;
+        usize size = 0;
+        iovec iov{};
+    };
+
+    std::vector<FileState> files(requests.size());
+
+    auto close_files = [&] {
+        for (auto& file : files)
+        {
+            if (file.fd >= 0)
+                close(file.fd);
+        }
+    };
+
+    // opening and sizing is metadata only and is usually served from the dentry/inode caches; the data
+    // reads are what's worth batching
+    for (usize i = 0; i < requests.size(); i++)
+    {
+        auto& request = requests[i];
+        auto& file = files[i];
+
+        request.bytes_read = 0;
+        file.fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (file.fd < 0) [[unlikely]]
+        {
+            auto error = errno;
+            close_files();
+
+            if (error == ENOENT || error == ENOTDIR)
+                throw InvalidFilePath{ std::format("Invalid file path: {}", request.path.string()) };
+
+            throw FailedToOpenFile{ std::format("Can't open file: {}", request.path.string()) };
+        }
+
+        struct stat file_stat;
+
+        if (fstat(file.fd, &file_stat) < 0
+            || static_cast<usize>(file_stat.st_size) > request.destination.size()) [[unlikely]]
+        {
+            close_files();
+            auto message = std::format("Can't read from file: {} (destination buffer too small)",
+                                       request.path.string());
+            throw FailedToReadFromFile{ message };
+        }
+
+        file.size = static_cast<usize>(file_stat.st_size);
+    }
+
+    std::vector<usize> queued;
+    queued.reserve(requests.size());
+
+    for (usize i = 0; i < requests.size(); i++)
+    {
+        if (files[i].size != 0)
+            queued.push_back(i);
+    }
+
+    usize in_flight = 0;
+    std::optional<usize> failed_request;
+
+    // Waits for every submitted read, the kernel may still be writing into the destinations through the
+    // iovecs in files. Returns false if the ring failed, then the remaining reads can't be waited for.
+    auto drain = [&] {
+        while (in_flight > _ring->pending_submissions)
+        {
+            auto result = _ring->submit_and_wait(1);
+
+            if (result < 0 && result != -EAGAIN && result != -EBUSY) [[unlikely]]
+                return false;
+
+            _ring->consume_completions([&](const io_uring_cqe&) { in_flight--; });
+        }
+
+        return true;
+    };
+
+    // Once the ring failed it's torn down for good, which also drops entries that were never submitted
+    // and completions that would otherwise be mistaken for the next batch's. Closing the ring cancels
+    // whatever couldn't be drained.
+    auto abandon_ring = [&] {
+        log_error("io_uring failed, falling back to the thread pool");
+        drain();
+        _ring.reset();
+        close_files();
+    };
+
+    while (!failed_request && (!queued.empty() || in_flight != 0))
+    {
+        // keep as many reads in flight as the rings allow
+        while (!queued.empty() && in_flight < _ring->cq_entries)
+        {
+            auto sqe = _ring->get_sqe();
+
+            if (!sqe)
+                break;
+
+            auto index = queued.back();
+            queued.pop_back();
+
+            auto& request = requests[index];
+            auto& file = files[index];
+            file.iov.iov_base = request.destination.data() + request.bytes_read;
+            file.iov.iov_len = file.size - request.bytes_read;
+
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = file.fd;
+            sqe->addr = reinterpret_cast<u64>(&file.iov);
+            sqe->len = 1;
+            sqe->off = request.bytes_read;
+            sqe->user_data = index;
+
+            in_flight++;
+        }
+
+        auto result = _ring->submit_and_wait(1);
+
+        // the completion queue is full or the kernel is short on memory, reap completions and try again
+        if (result == -EAGAIN || result == -EBUSY)
+            result = 0;
+
+        if (result < 0) [[unlikely]]
+        {
+            abandon_ring();
+            read_with_thread_pool(requests);
+            return;
+        }
+
+        _ring->consume_completions([&](const io_uring_cqe& cqe) {
+            auto index = static_cast<usize>(cqe.user_data);
+            in_flight--;
+
+            if (cqe.res == -EAGAIN || cqe.res == -EINTR)
+            {
+                queued.push_back(index);
+            }
+            else if (cqe.res < 0) [[unlikely]]
+            {
+                failed_request = index;
+            }
+            else
+            {
+                auto& request = requests[index];
+                request.bytes_read += static_cast<usize>(cqe.res);
+
+                // short read: queue the rest, unless the file was truncated under us
+                if (cqe.res != 0 && request.bytes_read < files[index].size)
+                    queued.push_back(index);
+            }
+        });
+    }
+
+    // after a failed read, whatever is still in flight
+    if (!drain()) [[unlikely]]
+        abandon_ring();
+    else
+        close_files();
+
+    if (failed_request) [[unlikely]]
+    {
+        auto message = std::format("Can't read from file: {}", requests[*failed_request].path.string());
+        throw FailedToReadFromFile{ message };
+    }
+#endif
+}
+
+auto BatchFileReader::read_files(std::span<const std::filesystem::path> paths) -> BatchReadResult
+{
+    std::vector<BatchReadRequest> requests(paths.size());
+    std::vector<usize> offsets(paths.size());
+    usize arena_size = 0;
+
+    for (usize i = 0; i < paths.size(); i++)
+    {
+        std::error_code error;
+        usize file_size = std::filesystem::file_size(paths[i], error);
+
+        if (error) [[unlikely]]
+            throw InvalidFilePath{ std::format("Invalid file path: {}", paths[i].string()) };
+
+        requests[i].path = paths[i];
+        requests[i].destination = { static_cast<std::byte*>(nullptr), file_size };
+        offsets[i] = arena_size;
+
+        // one extra byte per file for a null terminator, so text assets can be used as C strings
+        arena_size += file_size + 1;
+    }
+
+    BatchReadResult result;
+    result._arena = std::make_unique_for_overwrite<std::byte[]>(std::max(arena_size, usize{ 1 }));
+
+    for (usize i = 0; i < requests.size(); i++)
+        requests[i].destination = { result._arena.get() + offsets[i], requests[i].destination.size() };
+
+    read(requests);
+
+    result._files.reserve(requests.size());
+
+    for (usize i = 0; i < requests.size(); i++)
+    {
+        result._arena[offsets[i] + requests[i].bytes_read] = std::byte{ 0 };
+        result._files.emplace_back(requests[i].destination.data(), requests[i].bytes_read);
+    }
+
+    return result;
+}
+
+auto BatchFileReader::read_with_thread_pool(std::span<BatchReadRequest> requests) -> void
+{
+    // also reached when io_uring fails after construction
+    if (!_fallback_pool)
+    {
+        _owned_fallback_pool = std::make_unique<ThreadPool>();
+        _fallback_pool = _owned_fallback_pool.get();
+    }
+
+    std::vector<std::future<void>> reads;
+    reads.reserve(requests.size());
+
+    for (auto& request : requests)
+    {
+        reads.push_back(_fallback_pool->submit([&request] {
+            request.bytes_read = 0;
+
+            std::error_code error;
+            usize file_size = std::filesystem::file_size(request.path, error);
+
+            if (error) [[unlikely]]
+                throw InvalidFilePath{ std::format("Invalid file path: {}", request.path.string()) };
+
+            if (file_size > request.destination.size()) [[unlikely]]
+            {
+                auto message = std::format("Can't read from file: {} (destination buffer too small)",
+                                           request.path.string());
+                throw FailedToReadFromFile{ message };
+            }
+
+            std::ifstream file(request.path, std::ios::binary);
+
+            if (!file) [[unlikely]]
+                throw FailedToOpenFile{ std::format("Can't open file: {}", request.path.string()) };
+
+            file.read(reinterpret_cast<char*>(request.destination.data()),
+                      static_cast<std::streamsize>(file_size));
+            request.bytes_read = static_cast<usize>(file.gcount());
+
+            if (file.bad()) [[unlikely]]
+                throw FailedToReadFromFile{ std::format("Can't read from file: {}", request.path.string()) };
+        }));
+    }
+
+    // wait for all of them before rethrowing, the tasks reference the requests
+    for (auto& read : reads)
+        read.wait();
+
+    for (auto& read : reads)
+        read.get();
+}
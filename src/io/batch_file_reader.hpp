@@ -0,0 +1,70 @@
+#pragma once
+
+#include <filesystem>
+
+#include "io/file_io.hpp"
+
+class ThreadPool;
+
+struct BatchReadRequest
+{
+    std::filesystem::path path;
+    std::span<std::byte> destination; // must be at least as big as the file
+    usize bytes_read = 0;
+};
+
+// Every file of a batch, read into a single preallocated arena.
+class BatchReadResult
+{
+public:
+    [[nodiscard]] inline auto size() const noexcept -> usize { return _files.size(); }
+    [[nodiscard]] inline auto operator[](usize index) const noexcept -> std::span<const std::byte>
+    {
+        return _files[index];
+    }
+
+    [[nodiscard]] inline auto view(usize index) const noexcept -> std::string_view
+    {
+        return { reinterpret_cast<const char*>(_files[index].data()), _files[index].size() };
+    }
+
+private:
+    friend class BatchFileReader;
+
+    std::unique_ptr<std::byte[]> _arena{};
+    std::vector<std::span<const std::byte>> _files{};
+};
+
+// Reads many files at once. On Linux all reads of a batch are queued through io_uring, so the device
+// sees the whole batch instead of one request at a time. Where io_uring isn't available (other
+// platforms, old kernels, seccomp-filtered containers) the reads are spread across a thread pool.
+class BatchFileReader
+{
+public:
+    // fallback_pool is only used if io_uring is unavailable or fails; if it's null, the reader creates its
+    // own the first time it's needed
+    explicit BatchFileReader(u32 queue_depth = 128, ThreadPool* fallback_pool = nullptr);
+    ~BatchFileReader() noexcept;
+
+    BatchFileReader(const BatchFileReader& other) = delete;
+    BatchFileReader(BatchFileReader&& other) = delete;
+
+    // throws FileIoError
+    auto read(std::span<BatchReadRequest> requests) -> void;
+
+    // sizes every file, allocates one buffer for all of them and reads them in a single batch
+    // throws FileIoError
+    [[nodiscard]] auto read_files(std::span<const std::filesystem::path> paths) -> BatchReadResult;
+
+    [[nodiscard]] inline auto uses_io_uring() const noexcept -> bool { return _ring != nullptr; }
+
+private:
+    auto read_with_thread_pool(std::span<BatchReadRequest> requests) -> void;
+
+private:
+    struct IoUring;
+
+    std::unique_ptr<IoUring> _ring{};
+    ThreadPool* _fallback_pool;
+    std::unique_ptr<ThreadPool> _owned_fallback_pool{};
+};
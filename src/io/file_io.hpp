@@ -33,3 +33,10 @@ public:
     inline FailedToReadFromFile(const char* message) noexcept : FileIoError(message) {}
     inline FailedToReadFromFile(const std::string& message) noexcept : FileIoError(message) {}
 };
+
+class FailedToWriteToFile : public FileIoError
+{
+public:
+    inline FailedToWriteToFile(const char* message) noexcept : FileIoError(message) {}
+    inline FailedToWriteToFile(const std::string& message) noexcept : FileIoError(message) {}
+};
@@ -0,0 +1,134 @@
+#include "file_watcher.hpp"
+
+#include "core/log.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+[[nodiscard]] static auto get_last_write_time(const std::filesystem::path& path) noexcept
+    -> std::filesystem::file_time_type
+{
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : time;
+}
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher() noexcept : _inotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+    if (_inotify == -1) [[unlikely]]
+        log_warning("Warning: inotify isn't available, file changes are polled instead");
+}
+
+FileWatcher::~FileWatcher() noexcept
+{
+    if (_inotify != -1)
+        close(_inotify);
+}
+
+#else
+
+FileWatcher::FileWatcher() noexcept {}
+
+FileWatcher::~FileWatcher() noexcept {}
+
+#endif
+
+auto FileWatcher::watch(const std::filesystem::path& path) -> void
+{
+    auto file = std::filesystem::absolute(path).lexically_normal();
+
+    if (_files.contains(file))
+        return;
+
+    _files.emplace(file, get_last_write_time(file));
+
+#ifdef __linux__
+    if (_inotify == -1)
+        return;
+
+    auto directory = file.parent_path();
+
+    if (_unwatched_directories.contains(directory))
+        return;
+
+    for (const auto& [descriptor, watched_directory] : _watched_directories)
+    {
+        if (watched_directory == directory)
+            return;
+    }
+
+    // the directory rather than the file, since saving by renaming a new file over the old one would end a
+    // watch on the file itself
+    int descriptor = inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+    if (descriptor == -1) [[unlikely]]
+    {
+        log_warning("Warning: Can't watch directory {}, errno {}, its files are polled instead",
+                    directory.string(), errno);
+        _unwatched_directories.insert(std::move(directory));
+        return;
+    }
+
+    _watched_directories.emplace(descriptor, directory);
+#endif
+}
+
+auto FileWatcher::poll() -> std::vector<std::filesystem::path>
+{
+    std::vector<std::filesystem::path> changed;
+
+#ifdef __linux__
+    if (_inotify != -1)
+    {
+        alignas(inotify_event) std::array<char, 4096> buffer;
+
+        while (true)
+        {
+            auto size = read(_inotify, buffer.data(), buffer.size());
+
+            if (size <= 0)
+                break;
+
+            for (usize offset = 0; offset < static_cast<usize>(size);)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                auto directory = _watched_directories.find(event->wd);
+
+                if (event->len == 0 || directory == _watched_directories.end())
+                    continue;
+
+                auto file = directory->second / event->name;
+
+                if (_files.contains(file) && std::ranges::find(changed, file) == changed.end())
+                    changed.push_back(std::move(file));
+            }
+        }
+    }
+#endif
+
+    for (auto& [file, time] : _files)
+    {
+#ifdef __linux__
+        // inotify reports the files in watched directories, and never the others
+        if (_inotify != -1 && !_unwatched_directories.contains(file.parent_path()))
+            continue;
+#endif
+
+        auto current_time = get_last_write_time(file);
+
+        if (current_time != time)
+        {
+            time = current_time;
+            changed.push_back(file);
+        }
+    }
+
+    return changed;
+}
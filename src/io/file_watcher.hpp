@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+
+// Reports files that have been written to. On Linux the directories of the watched files are watched
+// with inotify, so polling is a single non-blocking read; elsewhere, and for files in directories
+// inotify can't watch, poll() compares modification times.
+//
+// Only completed writes count (IN_CLOSE_WRITE), as well as files renamed into place, which is how many
+// editors save; a half-written file is never reported.
+class FileWatcher
+{
+public:
+    FileWatcher() noexcept;
+    ~FileWatcher() noexcept;
+
+    FileWatcher(const FileWatcher& other) = delete;
+    FileWatcher(FileWatcher&& other) = delete;
+
+    // watching a file that doesn't exist yet is fine, it's reported once it's created
+    auto watch(const std::filesystem::path& path) -> void;
+
+    // absolute paths of the watched files changed since the last poll, each at most once; never blocks
+    [[nodiscard]] auto poll() -> std::vector<std::filesystem::path>;
+
+    [[nodiscard]] inline auto is_watching(const std::filesystem::path& path) const -> bool
+    {
+        return _files.contains(std::filesystem::absolute(path).lexically_normal());
+    }
+
+private:
+    // absolute and normalized, so the same file watched through different relative paths matches
+    std::map<std::filesystem::path, std::filesystem::file_time_type> _files{};
+
+#ifdef __linux__
+    int _inotify = -1;
+    std::map<int, std::filesystem::path> _watched_directories{}; // by watch descriptor
+    std::set<std::filesystem::path> _unwatched_directories{};     // inotify_add_watch failed
+#endif
+};
@@ -0,0 +1,26 @@
+#include "image.hpp"
+
+#include <stb_image.h>
+
+Image::Image(std::span<const std::byte> file_data, bool flip_vertically)
+{
+    // the thread-local variant, so images can be decoded on several threads at once
+    stbi_set_flip_vertically_on_load_thread(flip_vertically);
+
+    int width, height, channels;
+    auto pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file_data.data()),
+                                        static_cast<int>(file_data.size()), &width, &height, &channels, 0);
+
+    if (!pixels) [[unlikely]]
+        throw DecodeImageError{ std::format("Can't decode image: {}", stbi_failure_reason()) };
+
+    _width = static_cast<u32>(width);
+    _height = static_cast<u32>(height);
+    _channels = static_cast<u32>(channels);
+    _pixels.reset(pixels);
+}
+
+auto Image::PixelsDeleter::operator()(u8* pixels) const noexcept -> void
+{
+    stbi_image_free(pixels);
+}
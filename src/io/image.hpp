@@ -0,0 +1,41 @@
+#pragma once
+
+// Decoded 8-bit image, independent of any GL context, so decoding can happen on any thread.
+class Image
+{
+public:
+    // throws DecodeImageError
+    explicit Image(std::span<const std::byte> file_data, bool flip_vertically = true);
+
+    Image(const Image& other) = delete;
+    Image(Image&& other) = default;
+    auto operator=(const Image& other) -> Image& = delete;
+    auto operator=(Image&& other) -> Image& = default;
+
+    [[nodiscard]] inline auto width() const noexcept -> u32 { return _width; }
+    [[nodiscard]] inline auto height() const noexcept -> u32 { return _height; }
+    [[nodiscard]] inline auto channels() const noexcept -> u32 { return _channels; }
+
+    [[nodiscard]] inline auto pixels() const noexcept -> std::span<const u8>
+    {
+        return { _pixels.get(), static_cast<usize>(_width) * _height * _channels };
+    }
+
+private:
+    struct PixelsDeleter
+    {
+        auto operator()(u8* pixels) const noexcept -> void;
+    };
+
+    u32 _width = 0;
+    u32 _height = 0;
+    u32 _channels = 0;
+    std::unique_ptr<u8, PixelsDeleter> _pixels{};
+};
+
+class DecodeImageError : public std::runtime_error
+{
+public:
+    inline DecodeImageError(const char* message) noexcept : std::runtime_error(message) {}
+    inline DecodeImageError(const std::string& message) noexcept : std::runtime_error(message) {}
+};
@@ -0,0 +1,69 @@
+#include "image_decode_pool.hpp"
+
+#include "io/mapped_file.hpp"
+
+static constexpr u32 read_queue_depth = 128;
+
+ImageDecodePool::ImageDecodePool(usize thread_count)
+    : _owned_pool(std::make_unique<ThreadPool>(thread_count)), _pool(_owned_pool.get()),
+      _reader(read_queue_depth, _owned_pool.get())
+{
+}
+
+// the reader falls back to a pool of its own: reads on this one would wait behind whatever occupies it,
+// including the caller of decode_all() if that's one of its tasks
+ImageDecodePool::ImageDecodePool(ThreadPool& pool) : _pool(&pool), _reader(read_queue_depth) {}
+
+auto ImageDecodePool::decode(const std::filesystem::path& path, bool flip_vertically) -> std::future<Image>
+{
+    return _pool->submit([path, flip_vertically] {
+        MappedFile file(path);
+
+        try
+        {
+            return Image(file.bytes(), flip_vertically);
+        }
+        catch (DecodeImageError& e)
+        {
+            throw DecodeImageError{ std::format("{}: {}", path.string(), e.what()) };
+        }
+    });
+}
+
+auto ImageDecodePool::decode(std::span<const std::byte> file_data, bool flip_vertically) -> std::future<Image>
+{
+    return _pool->submit([file_data, flip_vertically] { return Image(file_data, flip_vertically); });
+}
+
+auto ImageDecodePool::decode_all(std::span<const std::filesystem::path> paths, bool flip_vertically)
+    -> std::vector<Image>
+{
+    auto files = _reader.read_files(paths);
+
+    std::vector<std::future<Image>> decodes;
+    decodes.reserve(files.size());
+
+    for (usize i = 0; i < files.size(); i++)
+        decodes.push_back(decode(files[i], flip_vertically));
+
+    // wait for every decode before anything can throw, they all reference the file buffers
+    for (auto& decode : decodes)
+        decode.wait();
+
+    std::vector<Image> images;
+    images.reserve(decodes.size());
+
+    for (usize i = 0; i < decodes.size(); i++)
+    {
+        try
+        {
+            images.push_back(decodes[i].get());
+        }
+        catch (DecodeImageError& e)
+        {
+            throw DecodeImageError{ std::format("{}: {}", paths[i].string(), e.what()) };
+        }
+    }
+
+    return images;
+}
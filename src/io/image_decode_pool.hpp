@@ -0,0 +1,48 @@
+#pragma once
+
+#include <filesystem>
+#include <future>
+
+#include "core/thread_pool.hpp"
+#include "io/batch_file_reader.hpp"
+#include "io/image.hpp"
+
+// Decodes images in parallel across a thread pool. Decoding only touches thread-local stb_image state,
+// so any number of decodes can run at once; the resulting Images are handed back for upload on the
+// context thread.
+class ImageDecodePool
+{
+public:
+    // 0 means one thread per hardware thread
+    explicit ImageDecodePool(usize thread_count = 0);
+    // decodes on a pool owned by someone else, which has to outlive the ImageDecodePool; without io_uring,
+    // files are read on a separate pool
+    explicit ImageDecodePool(ThreadPool& pool);
+
+    ImageDecodePool(const ImageDecodePool& other) = delete;
+    ImageDecodePool(ImageDecodePool&& other) = delete;
+
+    // the future holds FileIoError or DecodeImageError on failure
+    [[nodiscard]] auto decode(const std::filesystem::path& path, bool flip_vertically = true)
+        -> std::future<Image>;
+
+    // file_data has to stay alive until the future is ready
+    // the future holds DecodeImageError on failure
+    [[nodiscard]] auto decode(std::span<const std::byte> file_data, bool flip_vertically = true)
+        -> std::future<Image>;
+
+    // reads every file in one batch, then decodes them all in parallel
+    // blocks until the decodes are done, so don't call it from a thread of the pool: they'd be queued
+    // behind the caller, which never finishes with a single thread
+    // throws FileIoError, DecodeImageError
+    [[nodiscard]] auto decode_all(std::span<const std::filesystem::path> paths, bool flip_vertically = true)
+        -> std::vector<Image>;
+
+    [[nodiscard]] inline auto thread_count() const noexcept -> usize { return _pool->thread_count(); }
+    [[nodiscard]] inline auto uses_io_uring() const noexcept -> bool { return _reader.uses_io_uring(); }
+
+private:
+    std::unique_ptr<ThreadPool> _owned_pool{};
+    ThreadPool* _pool;
+    BatchFileReader _reader;
+};
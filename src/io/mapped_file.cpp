@@ -0,0 +1,184 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+[[nodiscard]] static auto page_size() noexcept -> usize
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<usize>(info.dwPageSize);
+#else
+    return static_cast<usize>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) [[unlikely]]
+    {
+        auto error = GetLastError();
+
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+            throw InvalidFilePath{ std::format("Invalid file path: {}", path.string()) };
+
+        throw FailedToOpenFile{ std::format("Can't open file: {}", path.string()) };
+    }
+
+    LARGE_INTEGER file_size;
+
+    if (!GetFileSizeEx(file, &file_size)) [[unlikely]]
+    {
+        CloseHandle(file);
+        throw FailedToReadFromFile{ std::format("Can't read from file: {}", path.string()) };
+    }
+
+    _size = static_cast<usize>(file_size.QuadPart);
+
+    if (_size != 0)
+    {
+        _file_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (_file_mapping)
+            _data = static_cast<const std::byte*>(MapViewOfFile(_file_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    CloseHandle(file);
+
+    if (_size != 0 && !_data) [[unlikely]]
+    {
+        unmap();
+        throw FailedToReadFromFile{ std::format("Can't map file: {}", path.string()) };
+    }
+
+    _mapping_is_null_terminated = _size % page_size() != 0;
+
+    if (!_mapping_is_null_terminated)
+        _null_terminated_copy = view();
+}
+
+auto MappedFile::unmap() noexcept -> void
+{
+    if (_data)
+        UnmapViewOfFile(_data);
+
+    if (_file_mapping)
+        CloseHandle(_file_mapping);
+
+    _data = nullptr;
+    _file_mapping = nullptr;
+    _size = 0;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1) [[unlikely]]
+    {
+        if (errno == ENOENT || errno == ENOTDIR)
+            throw InvalidFilePath{ std::format("Invalid file path: {}", path.string()) };
+
+        throw FailedToOpenFile{ std::format("Can't open file: {}", path.string()) };
+    }
+
+    struct stat file_stat;
+
+    if (fstat(fd, &file_stat) == -1) [[unlikely]]
+    {
+        close(fd);
+        throw FailedToReadFromFile{ std::format("Can't read from file: {}", path.string()) };
+    }
+
+    _size = static_cast<usize>(file_stat.st_size);
+
+    if (_size != 0)
+    {
+        int flags = MAP_PRIVATE;
+
+#ifdef MAP_POPULATE
+        // assets are always read in full, so fault all pages in up front instead of one at a time
+        flags |= MAP_POPULATE;
+#endif
+
+        void* mapping = mmap(nullptr, _size, PROT_READ, flags, fd, 0);
+
+        if (mapping == MAP_FAILED) [[unlikely]]
+        {
+            close(fd);
+            _size = 0;
+            throw FailedToReadFromFile{ std::format("Can't map file: {}", path.string()) };
+        }
+
+        _data = static_cast<const std::byte*>(mapping);
+    }
+
+    close(fd);
+
+    _mapping_is_null_terminated = _size % page_size() != 0;
+
+    if (!_mapping_is_null_terminated)
+        _null_terminated_copy = view();
+}
+
+auto MappedFile::unmap() noexcept -> void
+{
+    if (_data)
+        munmap(const_cast<std::byte*>(_data), _size);
+
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() noexcept
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)),
+      _null_terminated_copy(std::move(other._null_terminated_copy)),
+      _mapping_is_null_terminated(other._mapping_is_null_terminated)
+#ifdef _WIN32
+      ,
+      _file_mapping(std::exchange(other._file_mapping, nullptr))
+#endif
+{
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+    if (this == &other)
+        return *this;
+
+    unmap();
+
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+    _null_terminated_copy = std::move(other._null_terminated_copy);
+    _mapping_is_null_terminated = other._mapping_is_null_terminated;
+#ifdef _WIN32
+    _file_mapping = std::exchange(other._file_mapping, nullptr);
+#endif
+
+    return *this;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <filesystem>
+
+#include "io/file_io.hpp"
+
+// Read-only view of a whole file mapped into memory. Nothing is copied; the views returned
+// stay valid for as long as the MappedFile is alive.
+class MappedFile
+{
+public:
+    // throws FileIoError
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    auto operator=(const MappedFile& other) -> MappedFile& = delete;
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+    [[nodiscard]] inline auto bytes() const noexcept -> std::span<const std::byte>
+    {
+        return { _data, _size };
+    }
+    [[nodiscard]] inline auto size() const noexcept -> usize { return _size; }
+    [[nodiscard]] inline auto empty() const noexcept -> bool { return _size == 0; }
+
+    [[nodiscard]] inline auto view() const noexcept -> std::string_view
+    {
+        return { reinterpret_cast<const char*>(_data), _size };
+    }
+
+    // same contents as view(), but view.data()[view.size()] is guaranteed to be '\0', so it can be
+    // handed to APIs expecting C strings (e.g. glShaderSource without lengths)
+    [[nodiscard]] inline auto null_terminated_view() const noexcept -> std::string_view
+    {
+        if (_mapping_is_null_terminated) [[likely]]
+            return view();
+
+        return _null_terminated_copy;
+    }
+
+private:
+    auto unmap() noexcept -> void;
+
+private:
+    const std::byte* _data = nullptr;
+    usize _size = 0;
+
+    // the kernel zero-fills the tail of the last mapped page, so the mapping itself is
+    // null-terminated unless the file size is an exact multiple of the page size; only in that
+    // case (and for empty files) we fall back to a copy
+    std::string _null_terminated_copy{};
+    bool _mapping_is_null_terminated = false;
+
+#ifdef _WIN32
+    void* _file_mapping = nullptr;
+#endif
+};
@@ -1,13 +1,26 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <glm/gtc/matrix_transform.hpp>
 
+#include <cmath>
+
+#include "bench/benchmarks.hpp"
+#include "checks/gl_checks.hpp"
 #include "core/log.hpp"
+#include "gl/embedded_shaders.hpp"
+#include "gl/gl_state.hpp"
 #include "gl/index_buffer.hpp"
+#include "gl/program_binary_cache.hpp"
 #include "gl/shader.hpp"
+#include "gl/shader_hot_reloader.hpp"
+#include "gl/sprite_batch.hpp"
 #include "gl/texture.hpp"
-#include "gl/vertex_array.hpp"
+#include "gl/uniform_buffer.hpp"
+#include "gl/vertex_array_cache.hpp"
 #include "gl/vertex_buffer.hpp"
 #include "gl/vertex_buffer_layout.hpp"
+#include "gl/vertex_quantization.hpp"
+#include "io/asset_loader.hpp"
 #include "window/gl_window.hpp"
 
 // TODO: OpenGL error reporting
@@ -16,6 +29,13 @@ static constexpr std::string_view window_title = "Example";
 static constexpr int window_width = 800;
 static constexpr int window_height = 600;
 
+static constexpr std::chrono::microseconds asset_loading_budget_per_frame{ 2000 };
+static constexpr std::chrono::microseconds shader_reload_budget_per_frame{ 1000 };
+static constexpr std::string_view program_binary_cache_directory = "cache/programs";
+
+// sprites along the bottom edge, see run_benchmarks() for SpriteBatch throughput
+static constexpr u32 sprite_count = 8;
+
 static constexpr GlWindowHints window_hints = {
     .gl_context_version_major = 4,
     .gl_context_version_minor = 3,
@@ -23,6 +43,22 @@ static constexpr GlWindowHints window_hints = {
     .gl_debug_context = true,
 };
 
+static constexpr GlWindowHints hidden_window_hints = {
+    .gl_context_version_major = 4,
+    .gl_context_version_minor = 3,
+    .gl_profile = GLFW_OPENGL_CORE_PROFILE,
+    .gl_debug_context = true,
+    .visible = false,
+};
+
+// the Frame block in shaders/basic.frag
+struct FrameUniforms
+{
+    GLfloat time;
+};
+
+static constexpr u32 frame_uniforms_binding = 0;
+
 struct RectVertex
 {
     glm::vec2 position;
@@ -30,11 +66,41 @@ struct RectVertex
     glm::vec4 color;
 };
 
-int main()
+// RectVertex in 16 instead of 32 bytes, what's uploaded
+struct QuantizedRectVertex
+{
+    glm::vec2 position;
+    HalfVec2 tex_coords;
+    Normalized<glm::u8vec4> color;
+};
+
+[[nodiscard]] static auto has_argument(std::span<char*> arguments, std::string_view argument) -> bool
+{
+    return std::ranges::any_of(arguments.subspan(1), [&](const char* other) { return argument == other; });
+}
+
+// "--check": GL checks in a hidden window, the exit code tells whether they passed
+[[nodiscard]] static auto run_checks() -> int
+{
+    GlWindow window(window_title, window_width, window_height, &hidden_window_hints);
+    return run_gl_checks() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// "--benchmark": the batching benchmarks, without vsync
+static auto run_benchmark_mode() -> int
+{
+    GlWindow window(window_title, window_width, window_height, &window_hints);
+    window.set_vsync(false);
+    run_benchmarks();
+    return EXIT_SUCCESS;
+}
+
+static auto run_example() -> int
 {
     GlWindow window(window_title, window_width, window_height, &window_hints);
     window.set_vsync(true);
-    window.set_resize_callback([](GLFWwindow*, int width, int height) { glViewport(0, 0, width, height); });
+    window.set_resize_callback(
+        [](GLFWwindow*, int width, int height) { gl_state().set_viewport({ 0, 0, width, height }); });
 
     log_notification("{}", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
 
@@ -52,25 +118,106 @@ int main()
     };
     // clang-format on
 
-    VertexArray va;
-    VertexBuffer vb(std::span{ vertices }, GL_STATIC_DRAW);
+    VertexArrayCache vertex_arrays;
+    auto quantized_vertices = quantize_vertices<QuantizedRectVertex>(std::span<const RectVertex>{ vertices });
+    VertexBuffer vb(std::span{ quantized_vertices }, GL_STATIC_DRAW);
+    // a vertex array has to be bound for the index buffer upload
+    vertex_arrays.bind<QuantizedRectVertex>(vb.id(), 0);
     IndexBuffer ib(std::span{ indices }, GL_STATIC_DRAW);
-    bind_vertex_buffer_layout<RectVertex>();
 
-    Shader shader("shaders/basic.vert", "shaders/basic.frag");
-    Texture2D texture("res/emoji.png");
+    UniformBuffer<FrameUniforms> frame_uniforms;
+    frame_uniforms.bind(frame_uniforms_binding);
+
+    ProgramBinaryCache program_binary_cache(program_binary_cache_directory);
+    AssetLoader asset_loader(0, &program_binary_cache);
+    ShaderHotReloader shader_reloader;
+
+    // built from the sources embedded in the binary, no shader file is read before the first frame
+    const auto& vertex_src = embedded_shader(EmbeddedShaderId::basic_vert);
+    const auto& fragment_src = embedded_shader(EmbeddedShaderId::basic_frag);
+    Shader shader(vertex_src, fragment_src, &program_binary_cache);
+
+    // rendering with a mismatched layout would read garbage, the warning says what doesn't match
+    if (!shader.is_uniform_block_compatible<FrameUniforms>("Frame")) [[unlikely]]
+        return EXIT_FAILURE;
+
+    shader.set_unif<GLint>("sampler", 0);
+    shader_reloader.watch(shader, vertex_src.name, fragment_src.name);
+
+    auto texture_future = asset_loader.load_texture("res/emoji.png");
+    auto sprite_shader_future = asset_loader.load_shader("shaders/sprite.vert", "shaders/sprite.frag");
+
+    std::unique_ptr<Texture2D> texture;
+    std::unique_ptr<Shader> sprite_shader;
+    std::unique_ptr<SpriteBatch> sprite_batch;
 
     while (!window.should_close())
     {
+        asset_loader.update(asset_loading_budget_per_frame);
+        shader_reloader.update(shader_reload_budget_per_frame);
+
+        if (!texture && is_ready(texture_future))
+            texture = texture_future.get();
+
+        if (!sprite_shader && is_ready(sprite_shader_future))
+        {
+            sprite_shader = sprite_shader_future.get();
+            sprite_batch = std::make_unique<SpriteBatch>(*sprite_shader);
+
+            // the batch holds uniform handles into the old program
+            auto recreate_sprite_batch = [&](Shader& reloaded) {
+                sprite_batch = std::make_unique<SpriteBatch>(reloaded);
+            };
+            shader_reloader.watch(*sprite_shader, "shaders/sprite.vert", "shaders/sprite.frag", {},
+                                  recreate_sprite_batch);
+        }
+
         double time = glfwGetTime();
+        frame_uniforms.update({ .time = static_cast<GLfloat>(time) });
 
         glClear(GL_COLOR_BUFFER_BIT);
 
-        shader.set_unif<GLfloat>("time", static_cast<GLfloat>(time));
-        shader.set_unif<GLint>("sampler", 0);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+        if (sprite_batch && texture)
+        {
+            auto sprite_size = glm::vec2{ 1.0f / sprite_count, 1.0f / sprite_count };
+            auto blue = static_cast<f32>(std::sin(time)) * 0.5f + 0.5f;
+
+            sprite_batch->begin(glm::ortho(0.0f, 1.0f, 0.0f, 1.0f));
+
+            for (u32 i = 0; i < sprite_count; i++)
+            {
+                auto position = glm::vec2{ static_cast<f32>(i) * sprite_size.x, 0.0f };
+                auto color = glm::vec4{ position.x, 1.0f - position.x, blue, 1.0f };
+                sprite_batch->draw(*texture, { .position = position, .size = sprite_size, .color = color });
+            }
+
+            sprite_batch->end();
+        }
+
+        if (texture)
+        {
+            vertex_arrays.bind<QuantizedRectVertex>(vb.id(), ib.id());
+            shader.use();
+            texture->bind(0);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+        }
 
         window.swap_buffers();
         window.poll_events();
     }
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    auto arguments = std::span{ argv, static_cast<usize>(argc) };
+
+    if (has_argument(arguments, "--check"))
+        return run_checks();
+
+    if (has_argument(arguments, "--benchmark"))
+        return run_benchmark_mode();
+
+    return run_example();
 }
@@ -1,6 +1,7 @@
 #include "gl_window.hpp"
 
 #include "core/log.hpp"
+#include "gl/gl_extensions.hpp"
 
 static bool glfw_initialized = false;
 static bool glad_loaded = false;
@@ -28,6 +29,8 @@ static inline auto terminate_glfw() -> void
     if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
         return false;
 
+    load_gl_extensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+
     glad_loaded = true;
     return true;
 }
@@ -50,6 +53,7 @@ GlWindow::GlWindow(std::string_view title, u32 width, u32 height, const GlWindow
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, hints->gl_context_version_minor);
         glfwWindowHint(GLFW_OPENGL_PROFILE, hints->gl_profile);
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, hints->gl_debug_context);
+        glfwWindowHint(GLFW_VISIBLE, hints->visible);
     }
 
     _window = glfwCreateWindow(static_cast<int>(width), static_cast<int>(height), title.data(), NULL, NULL);
@@ -84,14 +88,17 @@ GlWindow::GlWindow(std::string_view title, u32 width, u32 height, const GlWindow
     glDebugMessageCallback(GlWindow::gl_debug_message_callback, nullptr);
 
     // set some sensible defaults
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    _state->set_blend_enabled(true);
+    _state->set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     _window_count++;
 }
 
 GlWindow::~GlWindow()
 {
+    if (GlState::current() == _state.get())
+        GlState::make_current(nullptr);
+
     glfwDestroyWindow(_window);
     _window_count--;
 
@@ -126,6 +133,7 @@ auto GlWindow::height() const noexcept -> u32
 auto GlWindow::make_context_current() const noexcept -> void
 {
     glfwMakeContextCurrent(_window);
+    GlState::make_current(_state.get());
 }
 
 auto GlWindow::set_resize_callback(OnResizeCallback callback) -> void
@@ -147,7 +155,7 @@ auto GlWindow::fill_viewport() const noexcept -> void
 
 auto GlWindow::set_viewport(GLint x, GLint y, GLsizei width, GLsizei height) const noexcept -> void
 {
-    glViewport(x, y, width, height);
+    _state->set_viewport({ .x = x, .y = y, .width = width, .height = height });
 }
 
 auto GlWindow::gl_debug_message_callback(GLenum, GLenum, GLuint, GLenum severity, GLsizei,
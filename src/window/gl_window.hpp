@@ -3,12 +3,15 @@
 #include <glad/glad.h>
 #include <glfw/glfw3.h>
 
+#include "gl/gl_state.hpp"
+
 struct GlWindowHints
 {
     i32 gl_context_version_major;
     i32 gl_context_version_minor;
     i32 gl_profile;
     bool gl_debug_context;
+    bool visible = true; // a hidden window still has a context, e.g. for offscreen checks
 };
 
 struct GlWindowSize
@@ -36,6 +39,7 @@ public:
     [[nodiscard]] auto width() const noexcept -> u32;
     [[nodiscard]] auto height() const noexcept -> u32;
 
+    // also makes the context's state tracker current on this thread, see gl_state()
     auto make_context_current() const noexcept -> void;
     auto set_resize_callback(OnResizeCallback callback) -> void;
     auto set_vsync(bool enabled) const noexcept -> void;
@@ -45,12 +49,15 @@ public:
     inline auto swap_buffers() const noexcept -> void { glfwSwapBuffers(_window); }
     inline auto poll_events() const noexcept -> void { glfwPollEvents(); }
 
+    [[nodiscard]] inline auto state() const noexcept -> GlState& { return *_state; }
+
 private:
     static auto gl_debug_message_callback(GLenum, GLenum, GLuint, GLenum severity, GLsizei,
                                           const GLchar* message, const void*) noexcept -> void;
 
 private:
     GLFWwindow* _window;
+    std::unique_ptr<GlState> _state = std::make_unique<GlState>();
 
     static u32 _window_count;
 };
@@ -0,0 +1,415 @@
+// Generates a header embedding GLSL sources as constexpr string tables, so shaders can be built without
+// reading files at runtime. Run by the build, see CMakeLists.txt:
+//
+//     embed_shaders <output header> <shader root> <shader files...>
+//
+// Each file gets an EmbeddedShaderId named after its path relative to the shader root, "basic.vert" becomes
+// EmbeddedShaderId::basic_vert. Comments and redundant whitespace are stripped; preprocessor directives keep
+// their own lines, everything between them is joined into a single line. Compiler messages for embedded
+// shaders therefore point at the stripped source.
+//
+// The sources are checked for what would otherwise only fail when the program is created: a missing
+// #version, unterminated comments, unbalanced brackets and #include, which isn't resolved here.
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using usize = std::size_t;
+using u32 = std::uint32_t;
+
+// in source characters, escaping can make a literal a bit longer
+static constexpr usize max_literal_length = 4096;
+
+struct ShaderFile
+{
+    std::filesystem::path path;
+    std::string id;
+    std::string source;
+};
+
+struct SourceError
+{
+    u32 line;
+    std::string message;
+};
+
+[[nodiscard]] static auto read_file(const std::filesystem::path& path) -> std::optional<std::string>
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) [[unlikely]]
+        return std::nullopt;
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return std::move(contents).str();
+}
+
+[[nodiscard]] static auto make_id(const std::filesystem::path& relative_path) -> std::string
+{
+    auto id = relative_path.generic_string();
+
+    for (auto& c : id)
+    {
+        if (!std::isalnum(static_cast<unsigned char>(c)))
+            c = '_';
+    }
+
+    if (id.empty() || std::isdigit(static_cast<unsigned char>(id.front())))
+        id.insert(0, "_");
+
+    return id;
+}
+
+// replaces every comment by a space, keeping the newlines in block comments so line numbers stay the same
+[[nodiscard]] static auto remove_comments(std::string_view source) -> std::expected<std::string, SourceError>
+{
+    std::string output;
+    output.reserve(source.size());
+
+    u32 line = 1;
+
+    for (usize i = 0; i < source.size(); i++)
+    {
+        if (source.substr(i, 2) == "//")
+        {
+            // a backslash before the newline would continue the comment, which GLSL leaves undefined
+            while (i < source.size() && source[i] != '\n')
+                i++;
+
+            output += ' ';
+
+            if (i < source.size())
+            {
+                output += '\n';
+                line++;
+            }
+        }
+        else if (source.substr(i, 2) == "/*")
+        {
+            auto start_line = line;
+            auto end = source.find("*/", i + 2);
+
+            if (end == std::string_view::npos) [[unlikely]]
+                return std::unexpected(SourceError{ start_line, "unterminated comment" });
+
+            output += ' ';
+
+            for (; i < end; i++)
+            {
+                if (source[i] == '\n')
+                {
+                    output += '\n';
+                    line++;
+                }
+            }
+
+            i = end + 1;
+        }
+        else
+        {
+            if (source[i] == '\n')
+                line++;
+
+            output += source[i];
+        }
+    }
+
+    return output;
+}
+
+[[nodiscard]] static auto validate(std::string_view source) -> std::optional<SourceError>
+{
+    constexpr std::string_view opening_brackets = "({[";
+    constexpr std::string_view closing_brackets = ")}]";
+
+    std::vector<std::pair<char, u32>> open_brackets;
+    bool has_version = false;
+    bool has_code = false;
+    bool in_directive = false;
+    u32 line = 0;
+
+    for (auto line_range : std::views::split(source, '\n'))
+    {
+        std::string_view text{ line_range.begin(), line_range.end() };
+        line++;
+
+        auto start = text.find_first_not_of(" \t\r");
+
+        if (start == std::string_view::npos)
+            continue;
+
+        text.remove_prefix(start);
+
+        if (in_directive)
+        {
+            in_directive = text.back() == '\\';
+            continue;
+        }
+
+        if (text.front() == '#')
+        {
+            in_directive = text.back() == '\\';
+
+            auto directive = text.substr(1);
+            directive.remove_prefix(std::min(directive.find_first_not_of(" \t"), directive.size()));
+
+            if (directive.starts_with("version"))
+            {
+                if (has_version || has_code) [[unlikely]]
+                    return SourceError{ line, "#version has to be the first directive" };
+
+                has_version = true;
+            }
+            else if (directive.starts_with("include")) [[unlikely]]
+            {
+                return SourceError{ line, "#include isn't supported in embedded shaders" };
+            }
+
+            // directives don't take part in bracket matching, #define bodies may be unbalanced on purpose
+            continue;
+        }
+
+        if (!has_version) [[unlikely]]
+            return SourceError{ line, "missing #version" };
+
+        has_code = true;
+
+        for (auto c : text)
+        {
+            if (auto opening = opening_brackets.find(c); opening != std::string_view::npos)
+            {
+                open_brackets.emplace_back(c, line);
+            }
+            else if (auto closing = closing_brackets.find(c); closing != std::string_view::npos)
+            {
+                if (open_brackets.empty() || open_brackets.back().first != opening_brackets[closing])
+                    [[unlikely]]
+                    return SourceError{ line, std::format("unmatched '{}'", c) };
+
+                open_brackets.pop_back();
+            }
+        }
+    }
+
+    if (!has_version) [[unlikely]]
+        return SourceError{ 1, "missing #version" };
+
+    if (!open_brackets.empty()) [[unlikely]]
+    {
+        auto [bracket, bracket_line] = open_brackets.back();
+        return SourceError{ bracket_line, std::format("unclosed '{}'", bracket) };
+    }
+
+    return std::nullopt;
+}
+
+// directives keep their own line, all other lines are joined; runs of whitespace become a single space
+[[nodiscard]] static auto strip_whitespace(std::string_view source) -> std::string
+{
+    std::string output;
+    output.reserve(source.size());
+
+    bool in_code_line = false;
+    bool in_directive = false;
+
+    for (auto line_range : std::views::split(source, '\n'))
+    {
+        std::string_view text{ line_range.begin(), line_range.end() };
+
+        auto start = text.find_first_not_of(" \t\r");
+
+        if (start == std::string_view::npos)
+            continue;
+
+        auto end = text.find_last_not_of(" \t\r");
+        text = text.substr(start, end - start + 1);
+
+        // a line ending in a backslash continues a directive on the next line
+        bool is_directive = in_directive || text.front() == '#';
+        in_directive = is_directive && text.back() == '\\';
+
+        if (is_directive && in_code_line)
+            output += '\n';
+        else if (!is_directive && in_code_line)
+            output += ' ';
+
+        bool in_space = false;
+
+        for (auto c : text)
+        {
+            if (c == ' ' || c == '\t' || c == '\r')
+            {
+                in_space = true;
+                continue;
+            }
+
+            if (in_space)
+                output += ' ';
+
+            in_space = false;
+            output += c;
+        }
+
+        in_code_line = !is_directive;
+
+        if (is_directive)
+            output += '\n';
+    }
+
+    if (in_code_line)
+        output += '\n';
+
+    return output;
+}
+
+[[nodiscard]] static auto escape(std::string_view text) -> std::string
+{
+    std::string output;
+    output.reserve(text.size());
+
+    for (auto c : text)
+    {
+        switch (c)
+        {
+        case '\\': output += "\\\\"; break;
+        case '"': output += "\\\""; break;
+        case '\n': output += "\\n"; break;
+        case '\t': output += "\\t"; break;
+        default: output += c; break;
+        }
+    }
+
+    return output;
+}
+
+[[nodiscard]] static auto generate_header(const std::vector<ShaderFile>& shaders) -> std::string
+{
+    std::string output;
+
+    output += "// Generated by tools/embed_shaders.cpp, don't edit.\n\n";
+    output += "#pragma once\n\n";
+    output += "#include \"gl/embedded_shader_source.hpp\"\n\n";
+
+    output += "enum class EmbeddedShaderId : u32\n{\n";
+
+    for (const auto& shader : shaders)
+        output += std::format("    {},\n", shader.id);
+
+    output += "};\n\n";
+
+    output += std::format("inline constexpr std::array<EmbeddedShaderSource, {}> embedded_shader_sources = "
+                          "{{ {{\n",
+                          shaders.size());
+
+    for (const auto& shader : shaders)
+    {
+        output += std::format("    {{ .name = \"{}\",\n      .source =",
+                              escape(shader.path.generic_string()));
+
+        // adjacent literals are concatenated, short ones stay below some compilers' literal length limits
+        std::string_view source = shader.source;
+
+        for (usize offset = 0; offset < source.size(); offset += max_literal_length)
+            output += std::format("\n          \"{}\"", escape(source.substr(offset, max_literal_length)));
+
+        output += " },\n";
+    }
+
+    output += "} };\n\n";
+
+    output += "[[nodiscard]] constexpr auto embedded_shader(EmbeddedShaderId id) noexcept\n"
+              "    -> const EmbeddedShaderSource&\n"
+              "{\n"
+              "    return embedded_shader_sources[static_cast<usize>(id)];\n"
+              "}\n";
+
+    return output;
+}
+
+auto main(int argc, char** argv) -> int
+{
+    if (argc < 3) [[unlikely]]
+    {
+        std::println(stderr, "usage: embed_shaders <output header> <shader root> <shader files...>");
+        return 1;
+    }
+
+    std::filesystem::path output_path = argv[1];
+    std::filesystem::path root = argv[2];
+
+    std::vector<ShaderFile> shaders;
+    bool failed = false;
+
+    for (int i = 3; i < argc; i++)
+    {
+        std::filesystem::path path = argv[i];
+        auto source = read_file(path);
+
+        if (!source) [[unlikely]]
+        {
+            std::println(stderr, "{}: error: can't read file", path.string());
+            failed = true;
+            continue;
+        }
+
+        auto without_comments = remove_comments(*source);
+        auto error = without_comments ? validate(*without_comments)
+                                      : std::optional{ without_comments.error() };
+
+        if (error) [[unlikely]]
+        {
+            std::println(stderr, "{}:{}: error: {}", path.string(), error->line, error->message);
+            failed = true;
+            continue;
+        }
+
+        auto relative_path = std::filesystem::relative(path, root);
+        shaders.push_back({ .path = std::filesystem::path{ root.filename() } / relative_path,
+                            .id = make_id(relative_path),
+                            .source = strip_whitespace(*without_comments) });
+    }
+
+    std::ranges::sort(shaders, {}, &ShaderFile::id);
+
+    for (usize i = 1; i < shaders.size(); i++)
+    {
+        if (shaders[i].id == shaders[i - 1].id) [[unlikely]]
+        {
+            std::println(stderr, "{}: error: id {} is taken by {}", shaders[i].path.string(), shaders[i].id,
+                         shaders[i - 1].path.string());
+            failed = true;
+        }
+    }
+
+    if (failed)
+        return 1;
+
+    auto header = generate_header(shaders);
+
+    if (output_path.has_parent_path())
+        std::filesystem::create_directories(output_path.parent_path());
+    std::ofstream output(output_path, std::ios::binary);
+    output << header;
+
+    if (!output) [[unlikely]]
+    {
+        std::println(stderr, "{}: error: can't write file", output_path.string());
+        return 1;
+    }
+
+    return 0;
+}